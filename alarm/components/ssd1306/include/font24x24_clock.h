@@ -0,0 +1,15 @@
+#pragma once
+
+#define FONT24X24_CLOCK_GLYPHS   (12)  // "0123456789: "
+#define FONT24X24_CLOCK_VARIANTS (4)   // bit0 = inverted, bit1 = flipped
+
+extern uint8_t const font24x24_clock_tr[FONT24X24_CLOCK_VARIANTS][FONT24X24_CLOCK_GLYPHS][3][24];
+
+// index in font24x24_clock_tr, or -1 when the character is not in the table
+static inline int font24x24_clock_idx(char const ch)
+{
+	if (ch >= '0' && ch <= '9') return ch - '0';
+	if (ch == ':') return 10;
+	if (ch == ' ') return 11;
+	return -1;
+}
@@ -0,0 +1,9 @@
+#pragma once
+
+#define FONT_PROP_FIRST   (0x20)  // ' '
+#define FONT_PROP_LAST    (0x7E)  // '~'
+#define FONT_PROP_SPACING (1)     // blank columns after each glyph
+
+extern uint8_t const font_prop_atlas[];
+extern uint16_t const font_prop_offset[FONT_PROP_LAST - FONT_PROP_FIRST + 1];
+extern uint8_t const font_prop_width[FONT_PROP_LAST - FONT_PROP_FIRST + 1];
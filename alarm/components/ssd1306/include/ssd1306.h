@@ -1,6 +1,7 @@
 #ifndef MAIN_SSD1306_H_
 #define MAIN_SSD1306_H_
 
+#include "freertos/FreeRTOS.h"
 #include "driver/spi_master.h"
 
 // Following definitions are bollowed from 
@@ -80,11 +81,19 @@ typedef enum {
 } ssd1306_scroll_type_t;
 
 typedef struct {
-	bool _valid; // Not using it anymore
+	bool _valid; // _sent mirrors the panel
 	int _segLen; // Not using it anymore
 	uint8_t _segs[128];
+	uint8_t _sent[128]; // last data sent to the panel
 } PAGE_t;
 
+typedef struct {
+	uint32_t bytes;			// bytes clocked onto the bus, incl. address and control bytes
+	uint32_t transactions;	// I2C START..STOP sequences, or SPI device transmits
+	uint32_t skipped;		// unchanged columns that ssd1306_show_dirty didn't resend
+	uint32_t wire_us;		// time the bytes take on the wire at the configured bus clock
+} ssd1306_stats_t;
+
 typedef struct {
 	int _address;
 	int _width;
@@ -96,18 +105,63 @@ typedef struct {
 	int _scStart;
 	int _scEnd;
 	int	_scDirection;
+	bool _hsEnable; // pages _hsStart.._hsEnd are under hardware scroll
+	int _hsStart;
+	int _hsEnd;
 	PAGE_t _page[8];
 	bool _flip;
+	ssd1306_stats_t _stats;
 } SSD1306_t;
 
+typedef enum {
+	ANIM_NONE = 0,
+	ANIM_WRAP = 1,
+	ANIM_FADEOUT = 2,
+	ANIM_REVEAL = 3
+} ssd1306_anim_type_t;
+
+typedef struct {
+	uint32_t frames;		// frames composed
+	uint32_t dropped;		// frames skipped because the caller was late
+	uint32_t frame_us_max;	// compose until flushed
+	uint32_t frame_us_sum;
+} ssd1306_anim_stats_t;
+
+// Effect as a state machine, advanced one step per frame by ssd1306_anim_step
+typedef struct {
+	ssd1306_anim_type_t _type; // ANIM_NONE when idle
+	int _step;
+	int _steps;
+	TickType_t _period; // frame clock [ticks], 0 for as fast as the caller steps
+	TickType_t _next; // when the next frame is due
+	bool _started;
+	int64_t _frame_start;
+	ssd1306_scroll_type_t _scroll; // ANIM_WRAP
+	int _start;
+	int _end;
+	int _xpos; // ANIM_REVEAL
+	int _ypos;
+	uint8_t const * _bitmap;
+	int _width;
+	int _height;
+	bool _invert;
+	ssd1306_anim_stats_t _stats;
+} ssd1306_anim_t;
+
 void ssd1306_init(SSD1306_t * dev, int width, int height);
 int ssd1306_get_width(SSD1306_t * dev);
 int ssd1306_get_height(SSD1306_t * dev);
 int ssd1306_get_pages(SSD1306_t * dev);
 void ssd1306_show_buffer(SSD1306_t * dev);
+void ssd1306_show_page(SSD1306_t * dev, int page, int seg, int width);
+void ssd1306_show_dirty(SSD1306_t * dev);
 void ssd1306_display_image(SSD1306_t * dev, int page, int seg, uint8_t * images, int width);
 void ssd1306_display_text(SSD1306_t * dev, int page, char * text, int text_len, bool invert);
 void ssd1306_display_text_x3(SSD1306_t * dev, int page, char * text, int text_len, bool invert);
+void ssd1306_compose_text(SSD1306_t * dev, int page, int seg, char const * text, int text_len, bool invert);
+void ssd1306_compose_text_x3(SSD1306_t * dev, int page, int seg, char const * text, int text_len, bool invert);
+int ssd1306_compose_text_prop(SSD1306_t * dev, int page, int seg, char const * text, int width, bool invert);
+int ssd1306_text_width_prop(char const * text);
 void ssd1306_clear_screen(SSD1306_t * dev, bool invert);
 void ssd1306_clear_line(SSD1306_t * dev, int page, bool invert);
 void ssd1306_contrast(SSD1306_t * dev, int contrast);
@@ -115,6 +169,7 @@ void ssd1306_software_scroll(SSD1306_t * dev, int start, int end);
 void ssd1306_scroll_text(SSD1306_t * dev, char * text, int text_len, bool invert);
 void ssd1306_scroll_clear(SSD1306_t * dev);
 void ssd1306_hardware_scroll(SSD1306_t * dev, ssd1306_scroll_type_t scroll);
+void ssd1306_hardware_scroll_pages(SSD1306_t * dev, ssd1306_scroll_type_t scroll, int start, int end, uint8_t interval);
 void ssd1306_wrap_arround(SSD1306_t * dev, ssd1306_scroll_type_t scroll, int start, int end, uint8_t delay);
 void ssd1306_bitmaps(SSD1306_t * dev, int xpos, int ypos, uint8_t * bitmap, int width, int height, bool invert);
 void ssd1306_invert(uint8_t *buf, size_t blen);
@@ -122,23 +177,36 @@ void ssd1306_flip(uint8_t *buf, size_t blen);
 uint8_t ssd1306_copy_bit(uint8_t src, int srcBits, uint8_t dst, int dstBits);
 uint8_t ssd1306_rotate_byte(uint8_t ch1);
 void ssd1306_fadeout(SSD1306_t * dev);
+void ssd1306_anim_wrap(ssd1306_anim_t * anim, ssd1306_scroll_type_t scroll, int start, int end, int steps, TickType_t period);
+void ssd1306_anim_fadeout(ssd1306_anim_t * anim, TickType_t period);
+void ssd1306_anim_reveal(ssd1306_anim_t * anim, int xpos, int ypos, uint8_t const * bitmap, int width, int height, bool invert, TickType_t period);
+bool ssd1306_anim_active(ssd1306_anim_t const * anim);
+TickType_t ssd1306_anim_wait(ssd1306_anim_t const * anim, TickType_t now);
+bool ssd1306_anim_step(SSD1306_t * dev, ssd1306_anim_t * anim, TickType_t now);
+void ssd1306_anim_flushed(ssd1306_anim_t * anim);
+void ssd1306_anim_run(SSD1306_t * dev, ssd1306_anim_t * anim);
+void ssd1306_anim_get_stats(ssd1306_anim_t * anim, ssd1306_anim_stats_t * stats, bool reset);
+void ssd1306_get_stats(SSD1306_t * dev, ssd1306_stats_t * stats, bool reset);
 void ssd1306_dump(SSD1306_t dev);
 void ssd1306_dump_page(SSD1306_t * dev, int page, int seg);
+void ssd1306_dump_pbm(SSD1306_t * dev);
 
 void i2c_master_init(SSD1306_t * dev, int16_t sda, int16_t scl, int16_t reset);
 void i2c_init(SSD1306_t * dev, int width, int height);
 void i2c_display_image(SSD1306_t * dev, int page, int seg, uint8_t * images, int width);
 void i2c_contrast(SSD1306_t * dev, int contrast);
 void i2c_hardware_scroll(SSD1306_t * dev, ssd1306_scroll_type_t scroll);
+void i2c_hardware_scroll_pages(SSD1306_t * dev, ssd1306_scroll_type_t scroll, int start, int end, uint8_t interval);
 
 void spi_master_init(SSD1306_t * dev, int16_t GPIO_MOSI, int16_t GPIO_SCLK, int16_t GPIO_CS, int16_t GPIO_DC, int16_t GPIO_RESET);
-bool spi_master_write_byte(spi_device_handle_t SPIHandle, const uint8_t* Data, size_t DataLength );
 bool spi_master_write_command(SSD1306_t * dev, uint8_t Command );
 bool spi_master_write_data(SSD1306_t * dev, const uint8_t* Data, size_t DataLength );
 void spi_init(SSD1306_t * dev, int width, int height);
 void spi_display_image(SSD1306_t * dev, int page, int seg, uint8_t * images, int width);
+bool spi_sync(SSD1306_t * dev);
 void spi_contrast(SSD1306_t * dev, int contrast);
 void spi_hardware_scroll(SSD1306_t * dev, ssd1306_scroll_type_t scroll);
+void spi_hardware_scroll_pages(SSD1306_t * dev, ssd1306_scroll_type_t scroll, int start, int end, uint8_t interval);
 
 #endif /* MAIN_SSD1306_H_ */
 
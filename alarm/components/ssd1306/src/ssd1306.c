@@ -4,9 +4,12 @@
 #include "freertos/task.h"
 
 #include "esp_log.h"
+#include "esp_timer.h"
 
 #include "ssd1306.h"
 #include "font8x8_basic.h"
+#include "font24x24_clock.h"
+#include "font_prop.h"
 
 #define TAG "SSD1306"
 
@@ -24,10 +27,12 @@ void ssd1306_init(SSD1306_t * dev, int width, int height)
 	} else {
 		i2c_init(dev, width, height);
 	}
-	// Initialize internal buffer
+	// Initialize internal buffer, the panel contents are unknown until the first full write
 	for (int i=0;i<dev->_pages;i++) {
 		memset(dev->_page[i]._segs, 0, 128);
+		dev->_page[i]._valid = false;
 	}
+	dev->_hsEnable = false;
 }
 
 int ssd1306_get_width(SSD1306_t * dev)
@@ -45,17 +50,78 @@ int ssd1306_get_pages(SSD1306_t * dev)
 	return dev->_pages;
 }
 
+// An SPI frame goes out as one burst of queued transactions.  When one failed, it is
+// unknown which runs made it to the panel, so all pages are resent the next time.
+static void _sync_frame(SSD1306_t * dev)
+{
+	if (dev->_address == SPIAddress && !spi_sync(dev)) {
+		for (int page=0; page<dev->_pages; page++) {
+			dev->_page[page]._valid = false;
+		}
+	}
+}
+
 void ssd1306_show_buffer(SSD1306_t * dev)
 {
+	for (int page=0; page<dev->_pages;page++) {
+		ssd1306_show_page(dev, page, 0, dev->_width);
+	}
+	_sync_frame(dev);
+}
+
+// Send a column range of the internal buffer in a single transfer.  Over SPI it is only
+// queued, and the buffer has to stay put until the caller waits for it with _sync_frame().
+void ssd1306_show_page(SSD1306_t * dev, int page, int seg, int width)
+{
+	if (page >= dev->_pages) return;
 	if (dev->_address == SPIAddress) {
-		for (int page=0; page<dev->_pages;page++) {
-			spi_display_image(dev, page, 0, dev->_page[page]._segs, dev->_width);
-		}
+		spi_display_image(dev, page, seg, &dev->_page[page]._segs[seg], width);
 	} else {
-		for (int page=0; page<dev->_pages;page++) {
-			i2c_display_image(dev, page, 0, dev->_page[page]._segs, dev->_width);
+		i2c_display_image(dev, page, seg, &dev->_page[page]._segs[seg], width);
+	}
+}
+
+// Cost of starting another run (address byte, addressing commands and control bytes).
+// Unchanged gaps shorter than this are cheaper to resend than to skip.
+#define SSD1306_RUN_OVERHEAD 8
+
+// Send only the columns of the internal buffer that differ from what the panel shows
+void ssd1306_show_dirty(SSD1306_t * dev)
+{
+	for (int page=0; page<dev->_pages; page++) {
+		// pages under hardware scroll are left alone, the controller keeps moving them
+		if (dev->_hsEnable && page >= dev->_hsStart && page <= dev->_hsEnd) continue;
+
+		PAGE_t * const p = &dev->_page[page];
+		if (!p->_valid) {
+			p->_valid = true;  // unless sending it fails
+			ssd1306_show_page(dev, page, 0, dev->_width);
+			continue;
 		}
+		int sent = 0;
+		int seg = 0;
+		while (seg < dev->_width) {
+			while (seg < dev->_width && p->_segs[seg] == p->_sent[seg]) seg++;
+			if (seg == dev->_width) break;
+
+			int const start = seg;
+			int end = seg + 1;
+			int clean = 0;
+			for (seg = start + 1; seg < dev->_width; seg++) {
+				if (p->_segs[seg] != p->_sent[seg]) {
+					end = seg + 1;
+					clean = 0;
+				} else if (++clean > SSD1306_RUN_OVERHEAD) {
+					break;
+				}
+			}
+			ssd1306_show_page(dev, page, start, end - start);
+			sent += end - start;
+			seg = end;
+		}
+		dev->_stats.skipped += dev->_width - sent;
 	}
+	_sync_frame(dev);
 }
 
 void ssd1306_display_image(SSD1306_t * dev, int page, int seg, uint8_t * images, int width)
@@ -67,6 +133,7 @@ void ssd1306_display_image(SSD1306_t * dev, int page, int seg, uint8_t * images,
 	}
 	// Set to internal buffer
 	memcpy(&dev->_page[page]._segs[seg], images, width);
+	_sync_frame(dev);  // the queued run still points into `images`
 }
 
 void ssd1306_display_text(SSD1306_t * dev, int page, char * text, int text_len, bool invert)
@@ -75,21 +142,25 @@ void ssd1306_display_text(SSD1306_t * dev, int page, char * text, int text_len,
 	int _text_len = text_len;
 	if (_text_len > 16) _text_len = 16;
 
-	uint8_t seg = 0;
-	uint8_t image[8];
+	// render the glyphs into the internal buffer, then send them as one run
+	ssd1306_compose_text(dev, page, 0, text, _text_len, invert);
+	ssd1306_show_page(dev, page, 0, _text_len * 8);
+	_sync_frame(dev);
+}
+
+// Render text into the internal buffer only; ssd1306_show_dirty() sends it
+void ssd1306_compose_text(SSD1306_t * dev, int page, int seg, char const * text, int text_len, bool invert)
+{
+	if (page >= dev->_pages) return;
+	int _text_len = text_len;
+	if (_text_len > (dev->_width - seg) / 8) _text_len = (dev->_width - seg) / 8;
+
+	uint8_t * image = &dev->_page[page]._segs[seg];
 	for (uint8_t i = 0; i < _text_len; i++) {
 		memcpy(image, font8x8_basic_tr[(uint8_t)text[i]], 8);
 		if (invert) ssd1306_invert(image, 8);
 		if (dev->_flip) ssd1306_flip(image, 8);
-		ssd1306_display_image(dev, page, seg, image, 8);
-#if 0
-		if (dev->_address == SPIAddress) {
-			spi_display_image(dev, page, seg, image, 8);
-		} else {
-			i2c_display_image(dev, page, seg, image, 8);
-		}
-#endif
-		seg = seg + 8;
+		image = image + 8;
 	}
 }
 
@@ -101,10 +172,34 @@ ssd1306_display_text_x3(SSD1306_t * dev, int page, char * text, int text_len, bo
 	int _text_len = text_len;
 	if (_text_len > 5) _text_len = 5;
 
-	uint8_t seg = 0;
+	ssd1306_compose_text_x3(dev, page, 0, text, _text_len, invert);
+	for (uint8_t yy = 0; yy < 3; yy++) {
+		ssd1306_show_page(dev, page+yy, 0, _text_len * 24);
+	}
+	_sync_frame(dev);
+}
+
+void
+ssd1306_compose_text_x3(SSD1306_t * dev, int page, int seg, char const * text, int text_len, bool invert)
+{
+	if (page + 3 > dev->_pages) return;
+	int _text_len = text_len;
+	if (_text_len > (dev->_width - seg) / 24) _text_len = (dev->_width - seg) / 24;
+
+	int const variant = (invert ? 1 : 0) | (dev->_flip ? 2 : 0);
 
 	for (uint8_t nn = 0; nn < _text_len; nn++) {
 
+		// clock glyphs are precomputed, ready to copy
+		int const idx = font24x24_clock_idx(text[nn]);
+		if (idx >= 0) {
+			for (uint8_t yy = 0; yy < 3; yy++) {
+				memcpy(&dev->_page[page+yy]._segs[seg], font24x24_clock_tr[variant][idx][yy], 24);
+			}
+			seg = seg + 24;
+			continue;
+		}
+
 		uint8_t const * const in_columns = font8x8_basic_tr[(uint8_t)text[nn]];
 
 		// make the character 3x as high
@@ -128,7 +223,7 @@ ssd1306_display_text_x3(SSD1306_t * dev, int page, char * text, int text_len, bo
 		// render character in 8 column high pieces, making them 3x as wide
 		for (uint8_t yy = 0; yy < 3; yy++)  {  // for each group of 8 pixels high (y-direction)
 
-			uint8_t image[24];
+			uint8_t * const image = &dev->_page[page+yy]._segs[seg];
 			for (uint8_t xx = 0; xx < 8; xx++) {  // for each column (x-direction)
 				image[xx*3+0] = 
 				image[xx*3+1] = 
@@ -136,16 +231,59 @@ ssd1306_display_text_x3(SSD1306_t * dev, int page, char * text, int text_len, bo
 			}
 			if (invert) ssd1306_invert(image, 24);
 			if (dev->_flip) ssd1306_flip(image, 24);
-			if (dev->_address == SPIAddress) {
-				spi_display_image(dev, page+yy, seg, image, 24);
-			} else {
-				i2c_display_image(dev, page+yy, seg, image, 24);
-			}
 		}
 		seg = seg + 24;
 	}
 }
 
+// Glyph index in the proportional font.  A UTF-8 sequence shows as a single '?'.
+static int _prop_idx(char const ch)
+{
+	uint8_t const code = ch;
+	if (code >= 0x80 && code < 0xC0) return -1;  // UTF-8 continuation byte
+	if (code < FONT_PROP_FIRST || code > FONT_PROP_LAST) return '?' - FONT_PROP_FIRST;
+	return code - FONT_PROP_FIRST;
+}
+
+// Width of `text` in the proportional font [columns]
+int ssd1306_text_width_prop(char const * text)
+{
+	int width = 0;
+	for (; *text; text++) {
+		int const idx = _prop_idx(*text);
+		if (idx >= 0) width += font_prop_width[idx] + FONT_PROP_SPACING;
+	}
+	return width;
+}
+
+// Render `text` in the proportional font into the internal buffer, in a single pass.
+// The text is clipped to `width` columns, and the columns it doesn't use are cleared.
+// Returns the number of columns used by the text.
+int ssd1306_compose_text_prop(SSD1306_t * dev, int page, int seg, char const * text, int width, bool invert)
+{
+	if (page >= dev->_pages) return 0;
+	if (seg + width > dev->_width) width = dev->_width - seg;
+
+	uint8_t * const image = &dev->_page[page]._segs[seg];
+	int xx = 0;
+	for (; *text && xx < width; text++) {
+		int const idx = _prop_idx(*text);
+		if (idx < 0) continue;
+		int glyph_width = font_prop_width[idx];
+		if (glyph_width > width - xx) glyph_width = width - xx;
+		memcpy(image + xx, &font_prop_atlas[font_prop_offset[idx]], glyph_width);
+		xx += glyph_width;
+		for (int ss = 0; ss < FONT_PROP_SPACING && xx < width; ss++) {
+			image[xx++] = 0x00;
+		}
+	}
+	int const used = xx;
+	memset(image + xx, 0x00, width - xx);
+	if (invert) ssd1306_invert(image, width);
+	if (dev->_flip) ssd1306_flip(image, width);
+	return used;
+}
+
 void ssd1306_clear_screen(SSD1306_t * dev, bool invert)
 {
 	char space[16];
@@ -216,6 +354,7 @@ void ssd1306_scroll_text(SSD1306_t * dev, char * text, int text_len, bool invert
 	if (_text_len > 16) _text_len = 16;
 	
 	ssd1306_display_text(dev, srcIndex, text, text_len, invert);
+	_sync_frame(dev);  // the pages moved up above are queued too
 }
 
 void ssd1306_scroll_clear(SSD1306_t * dev)
@@ -236,6 +375,13 @@ void ssd1306_scroll_clear(SSD1306_t * dev)
 
 void ssd1306_hardware_scroll(SSD1306_t * dev, ssd1306_scroll_type_t scroll)
 {
+	// the controller moves the GDDRAM contents, so _sent no longer mirrors the panel
+	for (int page=0; page<dev->_pages; page++) {
+		dev->_page[page]._valid = false;
+	}
+	dev->_hsEnable = (scroll != SCROLL_STOP);
+	dev->_hsStart = 0;
+	dev->_hsEnd = dev->_pages - 1;
 	if (dev->_address == SPIAddress) {
 		spi_hardware_scroll(dev, scroll);
 	} else {
@@ -243,7 +389,43 @@ void ssd1306_hardware_scroll(SSD1306_t * dev, ssd1306_scroll_type_t scroll)
 	}
 }
 
-void ssd1306_wrap_arround(SSD1306_t * dev, ssd1306_scroll_type_t scroll, int start, int end, uint8_t delay)
+// Horizontally scroll pages `start` to `end`, while the other pages stay put
+// and can still be updated.  `interval` is the frame interval code (0x00 to 0x07)
+// from the datasheet.  SCROLL_STOP stops it.  Afterwards, the pages in the range
+// are at an unknown offset, so ssd1306_show_dirty() will rewrite them.
+void ssd1306_hardware_scroll_pages(SSD1306_t * dev, ssd1306_scroll_type_t scroll, int start, int end, uint8_t interval)
+{
+	if (start < 0 || end >= dev->_pages || start > end) return;
+	if (scroll != SCROLL_RIGHT && scroll != SCROLL_LEFT && scroll != SCROLL_STOP) return;
+
+	for (int page=start; page<=end; page++) {
+		dev->_page[page]._valid = false;
+	}
+	dev->_hsEnable = (scroll != SCROLL_STOP);
+	dev->_hsStart = start;
+	dev->_hsEnd = end;
+
+	// flipped, the panel is upside down, so are the page numbers and the direction
+	int _start = start;
+	int _end = end;
+	if (dev->_flip) {
+		_start = (dev->_pages - end) - 1;
+		_end = (dev->_pages - start) - 1;
+		if (scroll == SCROLL_RIGHT) {
+			scroll = SCROLL_LEFT;
+		} else if (scroll == SCROLL_LEFT) {
+			scroll = SCROLL_RIGHT;
+		}
+	}
+	if (dev->_address == SPIAddress) {
+		spi_hardware_scroll_pages(dev, scroll, _start, _end, interval);
+	} else {
+		i2c_hardware_scroll_pages(dev, scroll, _start, _end, interval);
+	}
+}
+
+// Move the internal buffer by one pixel, what falls off one side comes back on the other
+static void _wrap_step(SSD1306_t * dev, ssd1306_scroll_type_t scroll, int start, int end)
 {
 	if (scroll == SCROLL_RIGHT) {
 		int _start = start; // 0 to 7
@@ -362,129 +544,276 @@ void ssd1306_wrap_arround(SSD1306_t * dev, ssd1306_scroll_type_t scroll, int sta
 		}
 
 	}
+}
 
-	for (int page=0;page<dev->_pages;page++) {
-		if (dev->_address == SPIAddress) {
-			spi_display_image(dev, page, 0, dev->_page[page]._segs, 128);
-		} else {
-			i2c_display_image(dev, page, 0, dev->_page[page]._segs, 128);
-		}
-		if (delay) vTaskDelay(delay);
-	}
+void ssd1306_wrap_arround(SSD1306_t * dev, ssd1306_scroll_type_t scroll, int start, int end, uint8_t delay)
+{
+	ssd1306_anim_t anim;
+	ssd1306_anim_wrap(&anim, scroll, start, end, 1, 0);
+	ssd1306_anim_run(dev, &anim);
+	// as before, `delay` ticks for each page sent, callers pace their loop with it
+	if (delay) vTaskDelay(delay * dev->_pages);
+}
 
+// Transpose an 8x8 pixel block from bitmap rows (MSB is the leftmost pixel) to
+// page columns (LSB is the top pixel), with two 32-bit words (Hacker's Delight 7-3).
+static inline void _transpose8x8(uint8_t const rows[8], uint8_t columns[8])
+{
+	// bottom row goes in the MSB, so the result comes out with the top pixel in the LSB
+	uint32_t x = ((uint32_t)rows[7] << 24) | ((uint32_t)rows[6] << 16) | ((uint32_t)rows[5] << 8) | rows[4];
+	uint32_t y = ((uint32_t)rows[3] << 24) | ((uint32_t)rows[2] << 16) | ((uint32_t)rows[1] << 8) | rows[0];
+	uint32_t t;
+
+	t = (x ^ (x >> 7)) & 0x00AA00AA;  x = x ^ t ^ (t << 7);
+	t = (y ^ (y >> 7)) & 0x00AA00AA;  y = y ^ t ^ (t << 7);
+	t = (x ^ (x >> 14)) & 0x0000CCCC;  x = x ^ t ^ (t << 14);
+	t = (y ^ (y >> 14)) & 0x0000CCCC;  y = y ^ t ^ (t << 14);
+	t = (x & 0xF0F0F0F0) | ((y >> 4) & 0x0F0F0F0F);
+	y = ((x << 4) & 0xF0F0F0F0) | (y & 0x0F0F0F0F);
+	x = t;
+
+	columns[0] = x >> 24; columns[1] = x >> 16; columns[2] = x >> 8; columns[3] = x;
+	columns[4] = y >> 24; columns[5] = y >> 16; columns[6] = y >> 8; columns[7] = y;
 }
 
-void ssd1306_bitmaps(SSD1306_t * dev, int xpos, int ypos, uint8_t * bitmap, int width, int height, bool invert)
+// Blit a bitmap into the internal buffer, 8 rows at a time.  Each 8x8 block is
+// transposed to page columns and shifted across the page boundary as whole bytes.
+static void _bitmap_band(SSD1306_t * dev, int xpos, int ypos, uint8_t const * bitmap, int width, int height, bool invert, int row)
 {
-	uint8_t wk0;
-	uint8_t wk1;
-	uint8_t wk2;
-	uint8_t page = (ypos / 8);
-	uint8_t _seg = xpos;
-	uint8_t dstBits = (ypos % 8);
-	//ESP_LOGI(TAG, "ypos=%d page=%d dstBits=%d", ypos, page, dstBits);
-	int offset = 0;
-	for(int _height=0;_height<height;_height++) {
-		for (int index=0;index<width;index++) {
-			for (int srcBits=7; srcBits>=0; srcBits--) {
-				wk0 = dev->_page[page]._segs[_seg];
-
-				wk1 = bitmap[index+offset];
-				if (invert) wk1 = ~wk1;
-
-				//wk2 = ssd1306_copy_bit(bitmap[index+offset], srcBits, wk0, dstBits);
-				wk2 = ssd1306_copy_bit(wk1, srcBits, wk0, dstBits);
-				ESP_LOGD(TAG, "index=%d offset=%d page=%d _seg=%d, wk2=%02x", index, offset, page, _seg, wk2);
-				dev->_page[page]._segs[_seg] = wk2;
-				_seg++;
+	int const dstBits = (ypos % 8);
+	int const page = (ypos / 8) + (row / 8);
+	for (int index=0; index<width; index++) {
+		uint8_t rows[8];
+		for (int yy=0; yy<8; yy++) {
+			uint8_t wk = 0;
+			if (row + yy < height) {
+				wk = bitmap[(row + yy) * width + index];
+				if (invert) wk = ~wk;
 			}
+			rows[yy] = wk;
 		}
-		vTaskDelay(1);
-		offset = offset + width;
-		dstBits++;
-		_seg = xpos;
-		if (dstBits == 8) {
-			page++;
-			dstBits=0;
+		uint8_t columns[8];
+		_transpose8x8(rows, columns);
+
+		int const seg = xpos + index * 8;
+		for (int xx=0; xx<8 && seg+xx<dev->_width; xx++) {
+			if (page < dev->_pages) {
+				dev->_page[page]._segs[seg+xx] |= columns[xx] << dstBits;
+			}
+			if (dstBits && page+1 < dev->_pages) {
+				dev->_page[page+1]._segs[seg+xx] |= columns[xx] >> (8 - dstBits);
+			}
 		}
 	}
+}
 
-#if 0
-	for (int _seg=ypos;_seg<ypos+width*8;_seg++) {
-		ssd1306_dump_page(dev, page-1, _seg);
-	}
-	for (int _seg=ypos;_seg<ypos+width*8;_seg++) {
-		ssd1306_dump_page(dev, page, _seg);
-	}
-#endif
-	ssd1306_show_buffer(dev);
+void ssd1306_bitmaps(SSD1306_t * dev, int xpos, int ypos, uint8_t * bitmap, int width, int height, bool invert)
+{
+	ssd1306_anim_t anim;
+	ssd1306_anim_reveal(&anim, xpos, ypos, bitmap, width, height, invert, 0);
+	ssd1306_anim_run(dev, &anim);
 }
 
+// Invert four columns at a time
 void ssd1306_invert(uint8_t *buf, size_t blen)
 {
-	uint8_t wk;
-	for(int i=0; i<blen; i++){
-		wk = buf[i];
-		buf[i] = ~wk;
+	size_t i = 0;
+	for(; i+4<=blen; i+=4){
+		uint32_t wk;
+		memcpy(&wk, buf+i, 4);
+		wk = ~wk;
+		memcpy(buf+i, &wk, 4);
+	}
+	for(; i<blen; i++){
+		buf[i] = ~buf[i];
 	}
 }
 
-// Flip upside down
+// Reverse the bits in each of the four bytes of a word
+static inline uint32_t _rotate_bytes(uint32_t wk)
+{
+	wk = ((wk >> 1) & 0x55555555) | ((wk & 0x55555555) << 1);
+	wk = ((wk >> 2) & 0x33333333) | ((wk & 0x33333333) << 2);
+	wk = ((wk >> 4) & 0x0F0F0F0F) | ((wk & 0x0F0F0F0F) << 4);
+	return wk;
+}
+
+// Flip upside down, four columns at a time
 void ssd1306_flip(uint8_t *buf, size_t blen)
 {
-	for(int i=0; i<blen; i++){
+	size_t i = 0;
+	for(; i+4<=blen; i+=4){
+		uint32_t wk;
+		memcpy(&wk, buf+i, 4);
+		wk = _rotate_bytes(wk);
+		memcpy(buf+i, &wk, 4);
+	}
+	for(; i<blen; i++){
 		buf[i] = ssd1306_rotate_byte(buf[i]);
 	}
 }
 
 uint8_t ssd1306_copy_bit(uint8_t src, int srcBits, uint8_t dst, int dstBits)
 {
-	ESP_LOGD(TAG, "src=%02x srcBits=%d dst=%02x dstBits=%d", src, srcBits, dst, dstBits);
-	uint8_t smask = 0x01 << srcBits;
-	uint8_t _src = src & smask;
-	if (_src != 0) _src = 1;
-	uint8_t _wk = _src << dstBits;
-	uint8_t _dst = dst | _wk;
-	return _dst;
+	return dst | (((src >> srcBits) & 0x01) << dstBits);
 }
 
 
 // Rotate 8-bit data
 // 0x12-->0x48
 uint8_t ssd1306_rotate_byte(uint8_t ch1) {
-	uint8_t ch2 = 0;
-	for (int j=0;j<8;j++) {
-		ch2 = (ch2 << 1) + (ch1 & 0x01);
-		ch1 = ch1 >> 1;
-	}
-	return ch2;
+	return _rotate_bytes(ch1);
 }
 
 
 void ssd1306_fadeout(SSD1306_t * dev)
 {
-	void (*func)(SSD1306_t * dev, int page, int seg, uint8_t * images, int width);
-	if (dev->_address == SPIAddress) {
-		func = spi_display_image;
-	} else {
-		func = i2c_display_image;
-	}
+	ssd1306_anim_t anim;
+	ssd1306_anim_fadeout(&anim, 0);
+	ssd1306_anim_run(dev, &anim);
+}
 
-	uint8_t image[1];
-	for(int page=0; page<dev->_pages; page++) {
-		image[0] = 0xFF;
-		for(int line=0; line<8; line++) {
-			if (dev->_flip) {
-				image[0] = image[0] >> 1;
-			} else {
-				image[0] = image[0] << 1;
-			}
-			for(int seg=0; seg<128; seg++) {
-				(*func)(dev, page, seg, image, 1);
-				dev->_page[page]._segs[seg] = image[0];
+// Animations are state machines advanced by a frame clock, so the caller doesn't
+// block for the duration of the effect.  Each call to ssd1306_anim_step() composes
+// the frames that are due in the internal buffer.  The caller then sends it in one
+// batched update (e.g. ssd1306_show_dirty) and calls ssd1306_anim_flushed().
+// When the caller is late, the frames it missed are applied without being shown,
+// and counted as dropped, so the effect keeps its duration.
+
+static void _anim_init(ssd1306_anim_t * anim, ssd1306_anim_type_t type, int steps, TickType_t period)
+{
+	memset(anim, 0, sizeof(ssd1306_anim_t));
+	anim->_type = (steps > 0) ? type : ANIM_NONE;
+	anim->_steps = steps;
+	anim->_period = period;
+}
+
+// Move pages `start` to `end` (or columns, for up and down) one pixel per frame
+void ssd1306_anim_wrap(ssd1306_anim_t * anim, ssd1306_scroll_type_t scroll, int start, int end, int steps, TickType_t period)
+{
+	_anim_init(anim, ANIM_WRAP, steps, period);
+	anim->_scroll = scroll;
+	anim->_start = start;
+	anim->_end = end;
+}
+
+// Clear the display one pixel row per frame
+void ssd1306_anim_fadeout(ssd1306_anim_t * anim, TickType_t period)
+{
+	_anim_init(anim, ANIM_FADEOUT, 8 * 8, period);  // stops early on displays with less pages
+}
+
+// Draw a bitmap 8 rows per frame.  `bitmap` must stay valid until the animation ends.
+void ssd1306_anim_reveal(ssd1306_anim_t * anim, int xpos, int ypos, uint8_t const * bitmap, int width, int height, bool invert, TickType_t period)
+{
+	_anim_init(anim, ANIM_REVEAL, (height + 7) / 8, period);
+	anim->_xpos = xpos;
+	anim->_ypos = ypos;
+	anim->_bitmap = bitmap;
+	anim->_width = width;
+	anim->_height = height;
+	anim->_invert = invert;
+}
+
+bool ssd1306_anim_active(ssd1306_anim_t const * anim)
+{
+	return anim->_type != ANIM_NONE;
+}
+
+// Ticks until the next frame is due, or portMAX_DELAY when idle
+TickType_t ssd1306_anim_wait(ssd1306_anim_t const * anim, TickType_t now)
+{
+	if (anim->_type == ANIM_NONE) return portMAX_DELAY;
+	if (!anim->_started) return 0;
+	TickType_t const wait = anim->_next - now;
+	return ((int32_t)wait > 0) ? wait : 0;
+}
+
+static void _anim_apply(SSD1306_t * dev, ssd1306_anim_t * anim)
+{
+	int const step = anim->_step;
+	switch (anim->_type) {
+		case ANIM_WRAP:
+			_wrap_step(dev, anim->_scroll, anim->_start, anim->_end);
+			break;
+		case ANIM_FADEOUT: {
+			int const page = step / 8;
+			int const line = step % 8;
+			uint8_t const image = dev->_flip ? (0xFF >> (line + 1)) : (uint8_t)(0xFF << (line + 1));
+			memset(dev->_page[page]._segs, image, dev->_width);
+			if (page == dev->_pages - 1 && line == 7) {
+				anim->_type = ANIM_NONE;  // displays with less pages end early
 			}
+			break;
+		}
+		case ANIM_REVEAL:
+			_bitmap_band(dev, anim->_xpos, anim->_ypos, anim->_bitmap, anim->_width, anim->_height, anim->_invert, step * 8);
+			break;
+		case ANIM_NONE:
+			break;
+	}
+	if (++anim->_step == anim->_steps) {
+		anim->_type = ANIM_NONE;
+	}
+}
+
+// Compose the frame(s) that are due, returns true when the internal buffer changed
+bool ssd1306_anim_step(SSD1306_t * dev, ssd1306_anim_t * anim, TickType_t now)
+{
+	if (anim->_type == ANIM_NONE) return false;
+	if (anim->_started && (int32_t)(now - anim->_next) < 0) return false;
+
+	anim->_frame_start = esp_timer_get_time();
+
+	int frames = 1;
+	if (anim->_started && anim->_period) {
+		frames += (now - anim->_next) / anim->_period;
+	}
+	int applied = 0;
+	for (; applied < frames && anim->_type != ANIM_NONE; applied++) {
+		_anim_apply(dev, anim);
+	}
+	anim->_stats.frames++;
+	anim->_stats.dropped += applied - 1;
+
+	anim->_next = (anim->_started ? anim->_next : now) + frames * anim->_period;
+	anim->_started = true;
+	return true;
+}
+
+// The frame composed by ssd1306_anim_step went out
+void ssd1306_anim_flushed(ssd1306_anim_t * anim)
+{
+	uint32_t const us = esp_timer_get_time() - anim->_frame_start;
+	anim->_stats.frame_us_sum += us;
+	if (us > anim->_stats.frame_us_max) anim->_stats.frame_us_max = us;
+}
+
+// Play an animation to the end, blocking the caller
+void ssd1306_anim_run(SSD1306_t * dev, ssd1306_anim_t * anim)
+{
+	while (ssd1306_anim_active(anim)) {
+		TickType_t const wait = ssd1306_anim_wait(anim, xTaskGetTickCount());
+		if (wait) vTaskDelay(wait);
+		if (ssd1306_anim_step(dev, anim, xTaskGetTickCount())) {
+			ssd1306_show_dirty(dev);
+			ssd1306_anim_flushed(anim);
 		}
 	}
+	ESP_LOGD(TAG, "animation: %u frames, %u dropped, frame time max %u us",
+		anim->_stats.frames, anim->_stats.dropped, anim->_stats.frame_us_max);
+}
+
+void ssd1306_anim_get_stats(ssd1306_anim_t * anim, ssd1306_anim_stats_t * stats, bool reset)
+{
+	*stats = anim->_stats;
+	if (reset) memset(&anim->_stats, 0, sizeof(anim->_stats));
+}
+
+void ssd1306_get_stats(SSD1306_t * dev, ssd1306_stats_t * stats, bool reset)
+{
+	*stats = dev->_stats;
+	if (reset) memset(&dev->_stats, 0, sizeof(dev->_stats));
 }
 
 void ssd1306_dump(SSD1306_t dev)
@@ -500,3 +829,16 @@ void ssd1306_dump_page(SSD1306_t * dev, int page, int seg)
 	ESP_LOGI(TAG, "dev->_page[%d]._segs[%d]=%02x", page, seg, dev->_page[page]._segs[seg]);
 }
 
+// Print what was last sent to the panel as a plain PBM image, to capture frames from the console.
+void ssd1306_dump_pbm(SSD1306_t * dev)
+{
+	printf("P1\n%d %d\n", dev->_width, dev->_height);
+	for (int y=0; y<dev->_height; y++) {
+		// flipped pages hold their rows bit reversed
+		int const bit = dev->_flip ? 7 - (y % 8) : y % 8;
+		for (int x=0; x<dev->_width; x++) {
+			putchar((dev->_page[y / 8]._sent[x] >> bit) & 1 ? '1' : '0');
+		}
+		putchar('\n');
+	}
+}
@@ -38,6 +38,35 @@ void i2c_master_init(SSD1306_t * dev, int16_t sda, int16_t scl, int16_t reset)
 	}
 	dev->_address = I2CAddress;
 	dev->_flip = false;
+	memset(&dev->_stats, 0, sizeof(dev->_stats));
+}
+
+// Every command and display update goes out as one START..STOP sequence, built in
+// the same statically allocated command link.  That avoids the heap alloc/free pair that
+// i2c_cmd_link_create() costs per transaction.  Only oled_flush_task writes to
+// the panel, so the link doesn't need a lock.
+#define I2C_LINK_OPS 5	// start, address, header, data, stop
+static uint8_t _i2c_link_buf[I2C_LINK_RECOMMENDED_SIZE(I2C_LINK_OPS)];
+
+static esp_err_t _i2c_write(SSD1306_t * dev, uint8_t const * hdr, size_t hdr_len, uint8_t const * data, size_t data_len)
+{
+	i2c_cmd_handle_t cmd = i2c_cmd_link_create_static(_i2c_link_buf, sizeof(_i2c_link_buf));
+	if (cmd == NULL) return ESP_ERR_NO_MEM;
+
+	i2c_master_start(cmd);
+	i2c_master_write_byte(cmd, (dev->_address << 1) | I2C_MASTER_WRITE, true);
+	i2c_master_write(cmd, hdr, hdr_len, true);
+	if (data_len) i2c_master_write(cmd, data, data_len, true);
+	i2c_master_stop(cmd);
+	esp_err_t espRc = i2c_master_cmd_begin(I2C_NUM, cmd, 10/portTICK_PERIOD_MS);
+	i2c_cmd_link_delete_static(cmd);
+
+	// 9 clocks per byte (incl. ACK), plus START and STOP
+	uint32_t const bits = (1 + hdr_len + data_len) * 9 + 2;
+	dev->_stats.bytes += 1 + hdr_len + data_len;
+	dev->_stats.transactions++;
+	dev->_stats.wire_us += (bits * 1000000UL + I2C_MASTER_FREQ_HZ - 1) / I2C_MASTER_FREQ_HZ;
+	return espRc;
 }
 
 void i2c_init(SSD1306_t * dev, int width, int height) {
@@ -45,66 +74,49 @@ void i2c_init(SSD1306_t * dev, int width, int height) {
 	dev->_height = height;
 	dev->_pages = 8;
 	if (dev->_height == 32) dev->_pages = 4;
-	
-	i2c_cmd_handle_t cmd = i2c_cmd_link_create();
 
-	i2c_master_start(cmd);
-	i2c_master_write_byte(cmd, (dev->_address << 1) | I2C_MASTER_WRITE, true);
-	i2c_master_write_byte(cmd, OLED_CONTROL_BYTE_CMD_STREAM, true);
-	i2c_master_write_byte(cmd, OLED_CMD_DISPLAY_OFF, true);				// AE
-	i2c_master_write_byte(cmd, OLED_CMD_SET_MUX_RATIO, true);			// A8
-	if (dev->_height == 64) i2c_master_write_byte(cmd, 0x3F, true);
-	if (dev->_height == 32) i2c_master_write_byte(cmd, 0x1F, true);
-	i2c_master_write_byte(cmd, OLED_CMD_SET_DISPLAY_OFFSET, true);		// D3
-	i2c_master_write_byte(cmd, 0x00, true);
-	i2c_master_write_byte(cmd, OLED_CONTROL_BYTE_DATA_STREAM, true);	// 40
-	//i2c_master_write_byte(cmd, OLED_CMD_SET_SEGMENT_REMAP, true);		// A1
-	if (dev->_flip) {
-		i2c_master_write_byte(cmd, OLED_CMD_SET_SEGMENT_REMAP_0, true);		// A0
-	} else {
-		i2c_master_write_byte(cmd, OLED_CMD_SET_SEGMENT_REMAP_1, true);		// A1
-	}
-	i2c_master_write_byte(cmd, OLED_CMD_SET_COM_SCAN_MODE, true);		// C8
-	i2c_master_write_byte(cmd, OLED_CMD_SET_DISPLAY_CLK_DIV, true);		// D5
-	i2c_master_write_byte(cmd, 0x80, true);
-	i2c_master_write_byte(cmd, OLED_CMD_SET_COM_PIN_MAP, true);			// DA
-	if (dev->_height == 64) i2c_master_write_byte(cmd, 0x12, true);
-	if (dev->_height == 32) i2c_master_write_byte(cmd, 0x02, true);
-	i2c_master_write_byte(cmd, OLED_CMD_SET_CONTRAST, true);			// 81
-	i2c_master_write_byte(cmd, 0xFF, true);
-	i2c_master_write_byte(cmd, OLED_CMD_DISPLAY_RAM, true);				// A4
-	i2c_master_write_byte(cmd, OLED_CMD_SET_VCOMH_DESELCT, true);		// DB
-	i2c_master_write_byte(cmd, 0x40, true);
-	i2c_master_write_byte(cmd, OLED_CMD_SET_MEMORY_ADDR_MODE, true);	// 20
-	//i2c_master_write_byte(cmd, OLED_CMD_SET_HORI_ADDR_MODE, true);	// 00
-	i2c_master_write_byte(cmd, OLED_CMD_SET_PAGE_ADDR_MODE, true);		// 02
-	// Set Lower Column Start Address for Page Addressing Mode
-	i2c_master_write_byte(cmd, 0x00, true);
-	// Set Higher Column Start Address for Page Addressing Mode
-	i2c_master_write_byte(cmd, 0x10, true);
-	i2c_master_write_byte(cmd, OLED_CMD_SET_CHARGE_PUMP, true);			// 8D
-	i2c_master_write_byte(cmd, 0x14, true);
-	i2c_master_write_byte(cmd, OLED_CMD_DEACTIVE_SCROLL, true);			// 2E
-	i2c_master_write_byte(cmd, OLED_CMD_DISPLAY_NORMAL, true);			// A6
-	i2c_master_write_byte(cmd, OLED_CMD_DISPLAY_ON, true);				// AF
-
-	i2c_master_stop(cmd);
-
-	esp_err_t espRc = i2c_master_cmd_begin(I2C_NUM, cmd, 10/portTICK_PERIOD_MS);
+	uint8_t const hdr[] = {
+		OLED_CONTROL_BYTE_CMD_STREAM,
+		OLED_CMD_DISPLAY_OFF,				// AE
+		OLED_CMD_SET_MUX_RATIO,				// A8
+		(dev->_height == 64) ? 0x3F : 0x1F,
+		OLED_CMD_SET_DISPLAY_OFFSET,		// D3
+		0x00,
+		OLED_CONTROL_BYTE_DATA_STREAM,		// 40
+		dev->_flip ? OLED_CMD_SET_SEGMENT_REMAP_0 : OLED_CMD_SET_SEGMENT_REMAP_1,	// A0 or A1
+		OLED_CMD_SET_COM_SCAN_MODE,			// C8
+		OLED_CMD_SET_DISPLAY_CLK_DIV,		// D5
+		0x80,
+		OLED_CMD_SET_COM_PIN_MAP,			// DA
+		(dev->_height == 64) ? 0x12 : 0x02,
+		OLED_CMD_SET_CONTRAST,				// 81
+		0xFF,
+		OLED_CMD_DISPLAY_RAM,				// A4
+		OLED_CMD_SET_VCOMH_DESELCT,			// DB
+		0x40,
+		OLED_CMD_SET_MEMORY_ADDR_MODE,		// 20
+		OLED_CMD_SET_PAGE_ADDR_MODE,		// 02
+		0x00,								// Set Lower Column Start Address for Page Addressing Mode
+		0x10,								// Set Higher Column Start Address for Page Addressing Mode
+		OLED_CMD_SET_CHARGE_PUMP,			// 8D
+		0x14,
+		OLED_CMD_DEACTIVE_SCROLL,			// 2E
+		OLED_CMD_DISPLAY_NORMAL,			// A6
+		OLED_CMD_DISPLAY_ON					// AF
+	};
+	esp_err_t espRc = _i2c_write(dev, hdr, sizeof(hdr), NULL, 0);
 	if (espRc == ESP_OK) {
 		ESP_LOGI(tag, "OLED configured successfully");
 	} else {
 		ESP_LOGE(tag, "OLED configuration failed. code: 0x%.2X", espRc);
 	}
-	i2c_cmd_link_delete(cmd);
 }
 
 
 void i2c_display_image(SSD1306_t * dev, int page, int seg, uint8_t * images, int width) {
-	i2c_cmd_handle_t cmd;
-
 	if (page >= dev->_pages) return;
 	if (seg >= dev->_width) return;
+	if (seg + width > dev->_width) width = dev->_width - seg;
 
 	int _seg = seg + CONFIG_SSD1306_OFFSETX;
 	uint8_t columLow = _seg & 0x0F;
@@ -115,133 +127,105 @@ void i2c_display_image(SSD1306_t * dev, int page, int seg, uint8_t * images, int
 		_page = (dev->_pages - page) - 1;
 	}
 
-	cmd = i2c_cmd_link_create();
-	i2c_master_start(cmd);
-	i2c_master_write_byte(cmd, (dev->_address << 1) | I2C_MASTER_WRITE, true);
-
-	i2c_master_write_byte(cmd, OLED_CONTROL_BYTE_CMD_STREAM, true);
-	// Set Lower Column Start Address for Page Addressing Mode
-	i2c_master_write_byte(cmd, (0x00 + columLow), true);
-	// Set Higher Column Start Address for Page Addressing Mode
-	i2c_master_write_byte(cmd, (0x10 + columHigh), true);
-	// Set Page Start Address for Page Addressing Mode
-	i2c_master_write_byte(cmd, 0xB0 | _page, true);
-
-	i2c_master_stop(cmd);
-	i2c_master_cmd_begin(I2C_NUM, cmd, 10/portTICK_PERIOD_MS);
-	i2c_cmd_link_delete(cmd);
-
-	cmd = i2c_cmd_link_create();
-	i2c_master_start(cmd);
-	i2c_master_write_byte(cmd, (dev->_address << 1) | I2C_MASTER_WRITE, true);
-
-	i2c_master_write_byte(cmd, OLED_CONTROL_BYTE_DATA_STREAM, true);
-	i2c_master_write(cmd, images, width, true);
-
-	i2c_master_stop(cmd);
-	i2c_master_cmd_begin(I2C_NUM, cmd, 10/portTICK_PERIOD_MS);
-	i2c_cmd_link_delete(cmd);
+	// Co=1 control bytes let the addressing commands and the data stream share one transaction
+	uint8_t const hdr[] = {
+		OLED_CONTROL_BYTE_CMD_SINGLE, (0x00 + columLow),	// Set Lower Column Start Address for Page Addressing Mode
+		OLED_CONTROL_BYTE_CMD_SINGLE, (0x10 + columHigh),	// Set Higher Column Start Address for Page Addressing Mode
+		OLED_CONTROL_BYTE_CMD_SINGLE, (0xB0 | _page),		// Set Page Start Address for Page Addressing Mode
+		OLED_CONTROL_BYTE_DATA_STREAM
+	};
+	esp_err_t espRc = _i2c_write(dev, hdr, sizeof(hdr), images, width);
+	if (espRc == ESP_OK) {
+		memcpy(&dev->_page[page]._sent[seg], images, width);
+	} else {
+		// unknown what the panel holds now, so have ssd1306_show_dirty() resend the page
+		dev->_page[page]._valid = false;
+		ESP_LOGE(tag, "Display image failed. code: 0x%.2X", espRc);
+	}
 }
 
 void i2c_contrast(SSD1306_t * dev, int contrast) {
-	i2c_cmd_handle_t cmd;
 	int _contrast = contrast;
 	if (contrast < 0x0) _contrast = 0;
 	if (contrast > 0xFF) _contrast = 0xFF;
 
-	cmd = i2c_cmd_link_create();
-	i2c_master_start(cmd);
-	i2c_master_write_byte(cmd, (dev->_address << 1) | I2C_MASTER_WRITE, true);
-	i2c_master_write_byte(cmd, OLED_CONTROL_BYTE_CMD_STREAM, true);
-	i2c_master_write_byte(cmd, OLED_CMD_SET_CONTRAST, true);			// 81
-	i2c_master_write_byte(cmd, _contrast, true);
-	i2c_master_stop(cmd);
-	i2c_master_cmd_begin(I2C_NUM, cmd, 10/portTICK_PERIOD_MS);
-	i2c_cmd_link_delete(cmd);
+	uint8_t const hdr[] = {
+		OLED_CONTROL_BYTE_CMD_STREAM,
+		OLED_CMD_SET_CONTRAST,			// 81
+		_contrast
+	};
+	_i2c_write(dev, hdr, sizeof(hdr), NULL, 0);
 }
 
 
 void i2c_hardware_scroll(SSD1306_t * dev, ssd1306_scroll_type_t scroll) {
 	esp_err_t espRc;
 
-	i2c_cmd_handle_t cmd = i2c_cmd_link_create();
-	i2c_master_start(cmd);
-
-	i2c_master_write_byte(cmd, (dev->_address << 1) | I2C_MASTER_WRITE, true);
-	i2c_master_write_byte(cmd, OLED_CONTROL_BYTE_CMD_STREAM, true);
-
-	if (scroll == SCROLL_RIGHT) {
-		i2c_master_write_byte(cmd, OLED_CMD_HORIZONTAL_RIGHT, true);	// 26
-		i2c_master_write_byte(cmd, 0x00, true); // Dummy byte
-		i2c_master_write_byte(cmd, 0x00, true); // Define start page address
-		i2c_master_write_byte(cmd, 0x07, true); // Frame frequency
-		i2c_master_write_byte(cmd, 0x07, true); // Define end page address
-		i2c_master_write_byte(cmd, 0x00, true); //
-		i2c_master_write_byte(cmd, 0xFF, true); //
-		i2c_master_write_byte(cmd, OLED_CMD_ACTIVE_SCROLL, true);		// 2F
-	} 
-
-	if (scroll == SCROLL_LEFT) {
-		i2c_master_write_byte(cmd, OLED_CMD_HORIZONTAL_LEFT, true);		// 27
-		i2c_master_write_byte(cmd, 0x00, true); // Dummy byte
-		i2c_master_write_byte(cmd, 0x00, true); // Define start page address
-		i2c_master_write_byte(cmd, 0x07, true); // Frame frequency
-		i2c_master_write_byte(cmd, 0x07, true); // Define end page address
-		i2c_master_write_byte(cmd, 0x00, true); //
-		i2c_master_write_byte(cmd, 0xFF, true); //
-		i2c_master_write_byte(cmd, OLED_CMD_ACTIVE_SCROLL, true);		// 2F
-	} 
-
-	if (scroll == SCROLL_DOWN) {
-		i2c_master_write_byte(cmd, OLED_CMD_CONTINUOUS_SCROLL, true);	// 29
-		i2c_master_write_byte(cmd, 0x00, true); // Dummy byte
-		i2c_master_write_byte(cmd, 0x00, true); // Define start page address
-		i2c_master_write_byte(cmd, 0x07, true); // Frame frequency
-		//i2c_master_write_byte(cmd, 0x01, true); // Define end page address
-		i2c_master_write_byte(cmd, 0x00, true); // Define end page address
-		i2c_master_write_byte(cmd, 0x3F, true); // Vertical scrolling offset
-
-		i2c_master_write_byte(cmd, OLED_CMD_VERTICAL, true);			// A3
-		i2c_master_write_byte(cmd, 0x00, true);
-		if (dev->_height == 64)
-		//i2c_master_write_byte(cmd, 0x7F, true);
-		i2c_master_write_byte(cmd, 0x40, true);
-		if (dev->_height == 32)
-		i2c_master_write_byte(cmd, 0x20, true);
-		i2c_master_write_byte(cmd, OLED_CMD_ACTIVE_SCROLL, true);		// 2F
+	uint8_t hdr[16];
+	size_t len = 0;
+	hdr[len++] = OLED_CONTROL_BYTE_CMD_STREAM;
+
+	if (scroll == SCROLL_RIGHT || scroll == SCROLL_LEFT) {
+		hdr[len++] = (scroll == SCROLL_RIGHT) ? OLED_CMD_HORIZONTAL_RIGHT : OLED_CMD_HORIZONTAL_LEFT;	// 26 or 27
+		hdr[len++] = 0x00; // Dummy byte
+		hdr[len++] = 0x00; // Define start page address
+		hdr[len++] = 0x07; // Frame frequency
+		hdr[len++] = 0x07; // Define end page address
+		hdr[len++] = 0x00; //
+		hdr[len++] = 0xFF; //
+		hdr[len++] = OLED_CMD_ACTIVE_SCROLL;		// 2F
 	}
 
-	if (scroll == SCROLL_UP) {
-		i2c_master_write_byte(cmd, OLED_CMD_CONTINUOUS_SCROLL, true);	// 29
-		i2c_master_write_byte(cmd, 0x00, true); // Dummy byte
-		i2c_master_write_byte(cmd, 0x00, true); // Define start page address
-		i2c_master_write_byte(cmd, 0x07, true); // Frame frequency
-		//i2c_master_write_byte(cmd, 0x01, true); // Define end page address
-		i2c_master_write_byte(cmd, 0x00, true); // Define end page address
-		i2c_master_write_byte(cmd, 0x01, true); // Vertical scrolling offset
-
-		i2c_master_write_byte(cmd, OLED_CMD_VERTICAL, true);			// A3
-		i2c_master_write_byte(cmd, 0x00, true);
-		if (dev->_height == 64)
-		//i2c_master_write_byte(cmd, 0x7F, true);
-		i2c_master_write_byte(cmd, 0x40, true);
-		if (dev->_height == 32)
-		i2c_master_write_byte(cmd, 0x20, true);
-		i2c_master_write_byte(cmd, OLED_CMD_ACTIVE_SCROLL, true);		// 2F
+	if (scroll == SCROLL_DOWN || scroll == SCROLL_UP) {
+		hdr[len++] = OLED_CMD_CONTINUOUS_SCROLL;	// 29
+		hdr[len++] = 0x00; // Dummy byte
+		hdr[len++] = 0x00; // Define start page address
+		hdr[len++] = 0x07; // Frame frequency
+		hdr[len++] = 0x00; // Define end page address
+		hdr[len++] = (scroll == SCROLL_DOWN) ? 0x3F : 0x01; // Vertical scrolling offset
+
+		hdr[len++] = OLED_CMD_VERTICAL;			// A3
+		hdr[len++] = 0x00;
+		if (dev->_height == 64) hdr[len++] = 0x40;
+		if (dev->_height == 32) hdr[len++] = 0x20;
+		hdr[len++] = OLED_CMD_ACTIVE_SCROLL;		// 2F
 	}
 
 	if (scroll == SCROLL_STOP) {
-		i2c_master_write_byte(cmd, OLED_CMD_DEACTIVE_SCROLL, true);		// 2E
+		hdr[len++] = OLED_CMD_DEACTIVE_SCROLL;		// 2E
 	}
 
-	i2c_master_stop(cmd);
-	espRc = i2c_master_cmd_begin(I2C_NUM, cmd, 10/portTICK_PERIOD_MS);
+	espRc = _i2c_write(dev, hdr, len, NULL, 0);
 	if (espRc == ESP_OK) {
 		ESP_LOGD(tag, "Scroll command succeeded");
 	} else {
 		ESP_LOGE(tag, "Scroll command failed. code: 0x%.2X", espRc);
 	}
-
-	i2c_cmd_link_delete(cmd);
 }
 
+void i2c_hardware_scroll_pages(SSD1306_t * dev, ssd1306_scroll_type_t scroll, int start, int end, uint8_t interval) {
+	esp_err_t espRc;
+
+	uint8_t hdr[10];
+	size_t len = 0;
+	hdr[len++] = OLED_CONTROL_BYTE_CMD_STREAM;
+	hdr[len++] = OLED_CMD_DEACTIVE_SCROLL;		// 2E, must precede a new scroll setup
+
+	if (scroll == SCROLL_RIGHT || scroll == SCROLL_LEFT) {
+		hdr[len++] = (scroll == SCROLL_RIGHT) ? OLED_CMD_HORIZONTAL_RIGHT : OLED_CMD_HORIZONTAL_LEFT;	// 26 or 27
+		hdr[len++] = 0x00; // Dummy byte
+		hdr[len++] = start & 0x07; // Define start page address
+		hdr[len++] = interval & 0x07; // Frame frequency
+		hdr[len++] = end & 0x07; // Define end page address
+		hdr[len++] = 0x00; //
+		hdr[len++] = 0xFF; //
+		hdr[len++] = OLED_CMD_ACTIVE_SCROLL;		// 2F
+	}
+
+	espRc = _i2c_write(dev, hdr, len, NULL, 0);
+	if (espRc == ESP_OK) {
+		ESP_LOGD(tag, "Scroll command succeeded");
+	} else {
+		ESP_LOGE(tag, "Scroll command failed. code: 0x%.2X", espRc);
+	}
+}
@@ -25,6 +25,107 @@ static const int SPI_Command_Mode = 0;
 static const int SPI_Data_Mode = 1;
 static const int SPI_Frequency = 1000000;
 
+// Commands and data are copied to a staging buffer and queued as transactions, so
+// the driver sends them back to back using DMA.  Consecutive bytes with the same DC
+// level share a transaction.  The pre-transfer callback sets the DC line, taking the
+// GPIO and level from the transaction's `user` field.  The staging buffer and the
+// descriptors are reused once all queued transactions finished (spi_sync).  A
+// transaction that fails is remembered until spi_sync() reports it.
+// A full frame (8 pages of 3 command bytes and 128 data bytes) fits in one go.
+#define SPI_QUEUE_SIZE (16)
+#define SPI_STAGE_SIZE (8 * (3 + 128) + 32)
+
+static struct {
+	spi_transaction_t trans[SPI_QUEUE_SIZE];
+	uint8_t stage[SPI_STAGE_SIZE];
+	size_t stage_len;		// bytes in use in `stage`
+	int queued;				// transactions handed to the driver
+	int open;				// index of the transaction being filled, or -1
+	bool failed;			// a transaction failed since the last spi_sync()
+} _spi = { .open = -1 };
+
+#define SPI_USER(dc, level) ((void *)(intptr_t)(((dc) << 1) | (level)))
+
+static void IRAM_ATTR _spi_pre_transfer_cb(spi_transaction_t * t)
+{
+	intptr_t const user = (intptr_t)t->user;
+	gpio_set_level(user >> 1, user & 1);
+}
+
+// hand the transaction being filled to the driver
+static void _spi_submit(SSD1306_t * dev)
+{
+	if (_spi.open < 0) return;
+
+	spi_transaction_t * const t = &_spi.trans[_spi.open];
+	esp_err_t const ret = spi_device_queue_trans(dev->_SPIHandle, t, portMAX_DELAY);
+	if (ret == ESP_OK) {
+		_spi.queued++;
+	} else {
+		ESP_LOGE(tag, "spi_device_queue_trans=%d", ret);
+		_spi.failed = true;
+	}
+	_spi.open = -1;
+	dev->_stats.transactions++;
+}
+
+// wait for all queued transactions, after which the staging buffer can be reused
+static void _spi_wait(SSD1306_t * dev)
+{
+	_spi_submit(dev);
+	while (_spi.queued) {
+		spi_transaction_t * t;
+		esp_err_t const ret = spi_device_get_trans_result(dev->_SPIHandle, &t, portMAX_DELAY);
+		if (ret != ESP_OK) {
+			ESP_LOGE(tag, "spi_device_get_trans_result=%d", ret);
+			_spi.failed = true;
+		}
+		_spi.queued--;
+	}
+	_spi.stage_len = 0;
+}
+
+// same, returns false when a transaction failed since the last call
+bool spi_sync(SSD1306_t * dev)
+{
+	_spi_wait(dev);
+	bool const ok = !_spi.failed;
+	_spi.failed = false;
+	return ok;
+}
+
+// append to the staging buffer, in the same transaction if the DC level matches
+static bool _spi_append(SSD1306_t * dev, int level, const uint8_t * data, size_t len)
+{
+	while (len > 0) {
+		bool const same = _spi.open >= 0 && _spi.trans[_spi.open].user == SPI_USER(dev->_dc, level);
+		if (!same) {
+			_spi_submit(dev);
+			if (_spi.queued == SPI_QUEUE_SIZE) {
+				_spi_wait(dev);
+			}
+		}
+		if (_spi.stage_len == SPI_STAGE_SIZE) {
+			_spi_wait(dev);
+		}
+		if (_spi.open < 0) {
+			spi_transaction_t * const t = &_spi.trans[_spi.queued];
+			memset(t, 0, sizeof(spi_transaction_t));
+			t->tx_buffer = &_spi.stage[_spi.stage_len];
+			t->user = SPI_USER(dev->_dc, level);
+			_spi.open = _spi.queued;
+		}
+		size_t chunk = SPI_STAGE_SIZE - _spi.stage_len;
+		if (chunk > len) chunk = len;
+		memcpy(&_spi.stage[_spi.stage_len], data, chunk);
+		_spi.trans[_spi.open].length += chunk * 8;
+		_spi.stage_len += chunk;
+		data += chunk;
+		len -= chunk;
+	}
+	return true;
+}
+
 void spi_master_init(SSD1306_t * dev, int16_t GPIO_MOSI, int16_t GPIO_SCLK, int16_t GPIO_CS, int16_t GPIO_DC, int16_t GPIO_RESET)
 {
 	esp_err_t ret;
@@ -66,7 +167,8 @@ void spi_master_init(SSD1306_t * dev, int16_t GPIO_MOSI, int16_t GPIO_SCLK, int1
 	memset( &devcfg, 0, sizeof( spi_device_interface_config_t ) );
 	devcfg.clock_speed_hz = SPI_Frequency;
 	devcfg.spics_io_num = GPIO_CS;
-	devcfg.queue_size = 1;
+	devcfg.queue_size = SPI_QUEUE_SIZE;
+	devcfg.pre_cb = _spi_pre_transfer_cb;
 
 	spi_device_handle_t handle;
 	ret = spi_bus_add_device( LCD_HOST, &devcfg, &handle);
@@ -76,35 +178,24 @@ void spi_master_init(SSD1306_t * dev, int16_t GPIO_MOSI, int16_t GPIO_SCLK, int1
 	dev->_SPIHandle = handle;
 	dev->_address = SPIAddress;
 	dev->_flip = false;
+	memset(&dev->_stats, 0, sizeof(dev->_stats));
 }
 
 
-bool spi_master_write_byte(spi_device_handle_t SPIHandle, const uint8_t* Data, size_t DataLength )
-{
-	spi_transaction_t SPITransaction;
-
-	if ( DataLength > 0 ) {
-		memset( &SPITransaction, 0, sizeof( spi_transaction_t ) );
-		SPITransaction.length = DataLength * 8;
-		SPITransaction.tx_buffer = Data;
-		spi_device_transmit( SPIHandle, &SPITransaction );
-	}
-
-	return true;
-}
-
+// queued, call spi_sync() to wait for it to go out
 bool spi_master_write_command(SSD1306_t * dev, uint8_t Command )
 {
-	static uint8_t CommandByte = 0;
-	CommandByte = Command;
-	gpio_set_level( dev->_dc, SPI_Command_Mode );
-	return spi_master_write_byte( dev->_SPIHandle, &CommandByte, 1 );
+	dev->_stats.bytes += 1;
+	dev->_stats.wire_us += (8 * 1000000UL + SPI_Frequency - 1) / SPI_Frequency;
+	return _spi_append( dev, SPI_Command_Mode, &Command, 1 );
 }
 
+// queued, call spi_sync() to wait for it to go out
 bool spi_master_write_data(SSD1306_t * dev, const uint8_t* Data, size_t DataLength )
 {
-	gpio_set_level( dev->_dc, SPI_Data_Mode );
-	return spi_master_write_byte( dev->_SPIHandle, Data, DataLength );
+	dev->_stats.bytes += DataLength;
+	dev->_stats.wire_us += (DataLength * 8 * 1000000UL + SPI_Frequency - 1) / SPI_Frequency;
+	return _spi_append( dev, SPI_Data_Mode, Data, DataLength );
 }
 
 
@@ -151,6 +242,7 @@ void spi_init(SSD1306_t * dev, int width, int height)
 	spi_master_write_command(dev, OLED_CMD_DEACTIVE_SCROLL);		// 2E
 	spi_master_write_command(dev, OLED_CMD_DISPLAY_NORMAL);			// A6
 	spi_master_write_command(dev, OLED_CMD_DISPLAY_ON);				// AF
+	spi_sync(dev);
 }
 
 
@@ -158,6 +250,7 @@ void spi_display_image(SSD1306_t * dev, int page, int seg, uint8_t * images, int
 {
 	if (page >= dev->_pages) return;
 	if (seg >= dev->_width) return;
+	if (seg + width > dev->_width) width = dev->_width - seg;
 
 	int _seg = seg + CONFIG_SSD1306_OFFSETX;
 	uint8_t columLow = _seg & 0x0F;
@@ -176,6 +269,8 @@ void spi_display_image(SSD1306_t * dev, int page, int seg, uint8_t * images, int
 	spi_master_write_command(dev, 0xB0 | _page);
 
 	spi_master_write_data(dev, images, width);
+	_spi_submit(dev);  // in flight, while the caller prepares the next run
+	memcpy(&dev->_page[page]._sent[seg], images, width);
 
 }
 
@@ -186,6 +281,7 @@ void spi_contrast(SSD1306_t * dev, int contrast) {
 
 	spi_master_write_command(dev, OLED_CMD_SET_CONTRAST);			// 81
 	spi_master_write_command(dev, _contrast);
+	spi_sync(dev);
 }
 
 void spi_hardware_scroll(SSD1306_t * dev, ssd1306_scroll_type_t scroll)
@@ -252,4 +348,22 @@ void spi_hardware_scroll(SSD1306_t * dev, ssd1306_scroll_type_t scroll)
 	if (scroll == SCROLL_STOP) {
 		spi_master_write_command(dev, OLED_CMD_DEACTIVE_SCROLL);	// 2E
 	}
+	spi_sync(dev);
+}
+
+void spi_hardware_scroll_pages(SSD1306_t * dev, ssd1306_scroll_type_t scroll, int start, int end, uint8_t interval)
+{
+	spi_master_write_command(dev, OLED_CMD_DEACTIVE_SCROLL);		// 2E, must precede a new scroll setup
+
+	if (scroll == SCROLL_RIGHT || scroll == SCROLL_LEFT) {
+		spi_master_write_command(dev, (scroll == SCROLL_RIGHT) ? OLED_CMD_HORIZONTAL_RIGHT : OLED_CMD_HORIZONTAL_LEFT);	// 26 or 27
+		spi_master_write_command(dev, 0x00); // Dummy byte
+		spi_master_write_command(dev, start & 0x07); // Define start page address
+		spi_master_write_command(dev, interval & 0x07); // Frame frequency
+		spi_master_write_command(dev, end & 0x07); // Define end page address
+		spi_master_write_command(dev, 0x00); //
+		spi_master_write_command(dev, 0xFF); //
+		spi_master_write_command(dev, OLED_CMD_ACTIVE_SCROLL);		// 2F
+	}
+	spi_sync(dev);
 }
@@ -0,0 +1,78 @@
+/**
+ * @brief alarm_deadline, when the alarm timer should go off, and whether the alarm sounds
+ *
+ * © Copyright 2016, 2022, Sander and Coert Vonk
+ *
+ * This file is part of CALalarm.
+ *
+ * CALalarm is free software: you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * CALalarm is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with CALalarm.
+ * If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ **/
+
+#include <string.h>
+
+#include "alarm_deadline.h"
+
+// The alarm instant is wall clock time, but esp_timer counts from boot.  The timer is
+// therefore re-armed whenever the schedule or the wall clock changes.  When it goes off,
+// the wall clock is checked again: if the clock was set back in the meantime, it waits
+// for the remainder.  `last_fired` makes sure each alarm sounds only once, even when the
+// clock is set back past it, or a resync re-adds it.  An alarm that the clock jumped
+// past, by less than ALARM_DEADLINE_GRACE_SEC, still sounds right away.
+// Only depends on the C library, so it can be exercised on a host; alarm_timer.c
+// drives it from an esp_timer.
+
+void
+alarm_deadline_init(alarm_deadline_t * const ad)
+{
+    memset(ad, 0, sizeof(alarm_deadline_t));
+}
+
+// (Re)arm for `alarm`, or disarm when 0.  Returns the delay to start the timer with [us],
+// or ALARM_DEADLINE_NONE when it should not run.
+int64_t
+alarm_deadline_arm(alarm_deadline_t * const ad, time_t const alarm, int64_t const now_us)
+{
+    ad->armed = 0;
+    if (alarm <= ad->last_fired) {
+        return ALARM_DEADLINE_NONE;
+    }
+    int64_t const delay_us = (int64_t)alarm * 1000000 - now_us;
+    if (delay_us <= -(int64_t)ALARM_DEADLINE_GRACE_SEC * 1000000) {
+        return ALARM_DEADLINE_NONE;  // the clock jumped too far past it
+    }
+    ad->armed = alarm;
+    return delay_us > 0 ? delay_us : 0;
+}
+
+// The timer went off.  Sets `fire` when the alarm should sound now.  Returns the delay to
+// start the timer again with [us], when the clock was set back since it was armed, or
+// ALARM_DEADLINE_NONE.
+int64_t
+alarm_deadline_expired(alarm_deadline_t * const ad, int64_t const now_us, bool * const fire)
+{
+    *fire = false;
+    if (!ad->armed) {
+        return ALARM_DEADLINE_NONE;
+    }
+    int64_t const remaining_us = (int64_t)ad->armed * 1000000 - now_us;
+    if (remaining_us > 0) {
+        return remaining_us;
+    }
+    if (ad->armed > ad->last_fired) {
+        *fire = true;
+        ad->last_fired = ad->armed;
+    }
+    ad->armed = 0;
+    return ALARM_DEADLINE_NONE;
+}
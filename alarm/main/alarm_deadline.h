@@ -0,0 +1,16 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+#include <time.h>
+
+#define ALARM_DEADLINE_GRACE_SEC (60)  // an alarm the clock jumped past by less, still goes off
+#define ALARM_DEADLINE_NONE (-1)       // the timer should not run
+
+typedef struct alarm_deadline_t {
+    time_t armed;       // alarm the timer is armed for, 0 for none
+    time_t last_fired;  // newest alarm that went off
+} alarm_deadline_t;
+
+void alarm_deadline_init(alarm_deadline_t * const ad);
+int64_t alarm_deadline_arm(alarm_deadline_t * const ad, time_t const alarm, int64_t const now_us);
+int64_t alarm_deadline_expired(alarm_deadline_t * const ad, int64_t const now_us, bool * const fire);
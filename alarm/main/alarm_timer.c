@@ -0,0 +1,122 @@
+/**
+ * @brief alarm_timer, sounds the next alarm using a one-shot esp_timer
+ *
+ * © Copyright 2016, 2022, Sander and Coert Vonk
+ *
+ * This file is part of CALalarm.
+ *
+ * CALalarm is free software: you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * CALalarm is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with CALalarm.
+ * If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ **/
+
+#include <sys/time.h>
+#include <esp_log.h>
+#include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+
+#include "alarm_timer.h"
+#include "alarm_deadline.h"
+
+static char const * const TAG = "alarm_timer";
+
+// Drives alarm_deadline from a one-shot esp_timer, and sounds the buzzer when it says so.
+
+static struct {
+    SemaphoreHandle_t mutex;  // protects the fields below
+    esp_timer_handle_t timer;
+    ipc_t const * ipc;
+    alarm_deadline_t deadline;
+} _alarm;
+
+static int64_t
+_now_us(void)
+{
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return (int64_t)tv.tv_sec * 1000000 + tv.tv_usec;
+}
+
+static void
+_start(int64_t const delay_us)
+{
+    esp_timer_stop(_alarm.timer);  // ESP_ERR_INVALID_STATE when it isn't running
+    if (delay_us != ALARM_DEADLINE_NONE) {
+        ESP_ERROR_CHECK(esp_timer_start_once(_alarm.timer, delay_us));
+    }
+}
+
+static void
+_alarm_cb(void * unused)
+{
+    xSemaphoreTake(_alarm.mutex, portMAX_DELAY);
+    int64_t const now_us = _now_us();
+    time_t const armed = _alarm.deadline.armed;
+    bool fire;
+    _start(alarm_deadline_expired(&_alarm.deadline, now_us, &fire));  // again, when the clock was set back
+    if (fire) {
+        ESP_LOGI(TAG, "alarm %ld went off %lld us late", (long)armed, (long long)(now_us - (int64_t)armed * 1000000));
+        sendToBuzzer(TO_BUZZER_MSGTYPE_START, _alarm.ipc);
+    }
+    xSemaphoreGive(_alarm.mutex);
+}
+
+void
+alarm_timer_init(ipc_t const * const ipc)
+{
+    _alarm.ipc = ipc;
+    alarm_deadline_init(&_alarm.deadline);
+    _alarm.mutex = xSemaphoreCreateMutex();
+    assert(_alarm.mutex);
+    esp_timer_create_args_t const args = {
+        .callback = &_alarm_cb,
+        .name = "alarm",
+    };
+    ESP_ERROR_CHECK(esp_timer_create(&args, &_alarm.timer));
+}
+
+// (Re)arm for `alarm`, or disarm when 0.  Call whenever the next alarm or the wall clock
+// changed.  Calling it again with the same alarm is harmless, and corrects for the drift
+// between the wall clock and the timer.
+void
+alarm_timer_arm(time_t const alarm)
+{
+    xSemaphoreTake(_alarm.mutex, portMAX_DELAY);
+    _start(alarm_deadline_arm(&_alarm.deadline, alarm, _now_us()));
+    xSemaphoreGive(_alarm.mutex);
+}
+
+// The wall clock was stepped: re-arm for the same alarm, so the timer waits for the new
+// remainder.  Called from another task, possibly before alarm_timer_init().
+void
+alarm_timer_rearm(void)
+{
+    if (!_alarm.mutex) {
+        return;  // nothing armed yet
+    }
+    xSemaphoreTake(_alarm.mutex, portMAX_DELAY);
+    if (_alarm.deadline.armed) {
+        _start(alarm_deadline_arm(&_alarm.deadline, _alarm.deadline.armed, _now_us()));
+    }
+    xSemaphoreGive(_alarm.mutex);
+}
+
+// alarms up to here went off (or were skipped), and can be retired from the schedule
+time_t
+alarm_timer_last_fired(void)
+{
+    xSemaphoreTake(_alarm.mutex, portMAX_DELAY);
+    time_t const last_fired = _alarm.deadline.last_fired;
+    xSemaphoreGive(_alarm.mutex);
+    return last_fired;
+}
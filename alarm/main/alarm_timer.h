@@ -0,0 +1,9 @@
+#pragma once
+#include <time.h>
+#include "ipc/ipc.h"
+#include "alarm_deadline.h"  // ALARM_DEADLINE_GRACE_SEC
+
+void alarm_timer_init(ipc_t const * const ipc);
+void alarm_timer_arm(time_t const alarm);
+void alarm_timer_rearm(void);
+time_t alarm_timer_last_fired(void);
@@ -0,0 +1,116 @@
+/**
+ * @brief ambient_light, translates photo transistor readings to OLED contrast
+ *
+ * © Copyright 2016, 2022, Sander and Coert Vonk
+ * 
+ * This file is part of CALalarm.
+ * 
+ * CALalarm is free software: you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ * 
+ * CALalarm is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License along with CALalarm. 
+ * If not, see <https://www.gnu.org/licenses/>.
+ * 
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ **/
+
+#include <stdlib.h>
+
+#include "ambient_light.h"
+
+// Only depends on the C library, so recorded ADC traces can be replayed on a host.
+
+#ifndef ARRAY_SIZE
+#define ARRAY_SIZE(a) (sizeof(a) / sizeof(*(a)))
+#endif
+
+#define ADC_MAX (4095)              // 12-bit ADC
+#define FILTER_SHIFT (2)            // low-pass filter, each reading contributes 1/4, a ~35 s time constant at a reading per 10 s
+#define HYSTERESIS (48)             // ADC counts the reading has to move, before the target changes
+#define DARK (32)                   // filtered readings below this are a dark room
+#define MIN_CONTRAST_STEP (4)       // smaller contrast changes are not perceptible
+#define FADE_STEP (0)               // max contrast change per update, 0 jumps straight to the target
+
+// Contrast at ADC readings 0, 256, .. 4096.  With ADC_ATTEN_DB_0, the ADC reads 0.10 to
+// 0.95 Volts as 0 to 4095, and the voltage over the load resistor follows the photo
+// transistor current, so the light is proportional to 0.10 + 0.85 * adc / 4096 Volts.
+// Perceived brightness follows a 1/2.2 power of that, so the breakpoints are
+// 255 * ((0.10 + 0.85 * adc / 4096) / 0.95)^(1/2.2), except that a dark room (below
+// the 0.10 Volts the ADC can see) turns the panel all the way down.  To calibrate
+// against a specific panel, log the readings in _ambient_light_cb() at the light
+// levels of interest, and replace the breakpoints.
+static uint8_t const _adc2contrast[] = {
+    0, 111, 127, 141, 154, 165, 176, 186, 195, 203, 212, 220, 227, 235, 242, 248, 255
+};
+
+int
+ambient_light_adc2contrast(int const adc_raw)
+{
+    int const adc = adc_raw < 0 ? 0 : adc_raw > ADC_MAX ? ADC_MAX : adc_raw;
+    int const step = (ADC_MAX + 1) / (ARRAY_SIZE(_adc2contrast) - 1);
+    int const idx = adc / step;
+    int const frac = adc % step;
+    int const lo = _adc2contrast[idx];
+    int const hi = _adc2contrast[idx + 1];
+    return lo + (hi - lo) * frac / step;  // linear interpolation between the breakpoints
+}
+
+static int
+_median3(int const a, int const b, int const c)
+{
+    if (a > b) return b > c ? b : a < c ? a : c;
+    return a > c ? a : b < c ? b : c;
+}
+
+void
+ambient_light_init(ambient_light_t * const al)
+{
+    al->valid = false;
+}
+
+// Feed an (oversampled) ADC reading.  Returns true and sets `*contrast`, when
+// the panel contrast should change.
+bool
+ambient_light_update(ambient_light_t * const al, int const adc_raw, int * const contrast)
+{
+    if (!al->valid) {
+        al->valid = true;
+        al->prev[0] = al->prev[1] = adc_raw;
+        al->filtered = adc_raw << 4;
+        al->band = adc_raw;
+        al->target = ambient_light_adc2contrast(adc_raw);
+        al->contrast = al->target;
+        *contrast = al->contrast;
+        return true;
+    }
+    // a median of three drops a single outlier (a passing headlight), before it gets in the filter
+    int const median = _median3(al->prev[0], al->prev[1], adc_raw);
+    al->prev[0] = al->prev[1];
+    al->prev[1] = adc_raw;
+    al->filtered += ((median << 4) - al->filtered) >> FILTER_SHIFT;
+
+    int const filtered = al->filtered >> 4;
+    int const reading = filtered < DARK ? 0 : filtered;  // the filter takes long to get all the way down
+    bool const at_end = reading == 0 || reading >= ADC_MAX;  // so a dark room does reach contrast 0
+    if (abs(reading - al->band) > HYSTERESIS || (at_end && reading != al->band)) {
+        al->band = reading;
+        al->target = ambient_light_adc2contrast(reading);
+    }
+
+    int const delta = al->target - al->contrast;
+    if (delta == 0 || (abs(delta) < MIN_CONTRAST_STEP && al->target != 0 && al->target != 255)) {
+        return false;
+    }
+    int step = delta;
+    if (FADE_STEP && abs(step) > FADE_STEP) {
+        step = delta > 0 ? FADE_STEP : -FADE_STEP;
+    }
+    al->contrast += step;
+    *contrast = al->contrast;
+    return true;
+}
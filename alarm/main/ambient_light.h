@@ -0,0 +1,16 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+
+typedef struct ambient_light_t {
+    bool valid;        // set after the first reading
+    int prev[2];       // the two readings before this one, for the median [count]
+    int32_t filtered;  // low-pass filtered ADC reading [1/16 count]
+    int band;          // ADC reading at the center of the hysteresis band [count]
+    int target;        // contrast for `band`
+    int contrast;      // contrast last handed to the panel
+} ambient_light_t;
+
+void ambient_light_init(ambient_light_t * const al);
+bool ambient_light_update(ambient_light_t * const al, int const adc_raw, int * const contrast);
+int ambient_light_adc2contrast(int const adc_raw);
@@ -0,0 +1,533 @@
+/**
+ * @brief calendar_json, streaming parser for the JSON that Google Apps Script returns
+ *
+ * © Copyright 2016, 2022, Sander and Coert Vonk
+ *
+ * This file is part of CALalarm.
+ *
+ * CALalarm is free software: you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * CALalarm is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with CALalarm.
+ * If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ **/
+
+#include <string.h>
+#include <time.h>
+
+#include "calendar_json.h"
+
+// Decodes
+//   { "time": "2022-04-20 13:18:37",
+//     "pushId": "..",
+//     "hash": "..",
+//     "events": [ { "alarm": "..", "start": "..", "stop": "..", "title": ".." }, .. ] }
+// in a single pass, without allocating.  The payload can be fed in chunks as it
+// arrives.  Events go in the records that the caller supplies, and strings in the
+// caller's arena.  Other keys and values are skipped.  Events that don't fit, or that
+// miss a field, are counted in `events_dropped`.
+// Only depends on the C library, so it can be exercised on a host.
+
+typedef enum {
+    S_VALUE,           // expecting a value
+    S_VALUE_OR_CLOSE,  // after '['
+    S_KEY_OR_CLOSE,    // after '{'
+    S_KEY,             // after ',' in an object
+    S_COLON,
+    S_AFTER_VALUE,     // expecting ',' or the end of the object or array
+    S_STRING,
+    S_ESCAPE,
+    S_UNICODE,
+    S_LITERAL,         // number, true, false or null
+    S_DONE,
+    S_ERROR
+} state_t;
+
+typedef enum {
+    F_NONE,
+    F_KEY,
+    F_TIME,
+    F_PUSHID,
+    F_HASH,
+    F_EVENTS,
+    F_TITLE,
+    F_ALARM,
+    F_START,
+    F_STOP
+} field_t;
+
+#define EVENT_FIELD(f) (1 << ((f) - F_TITLE))  // bit in `event_fields`
+#define EVENT_FIELDS (EVENT_FIELD(F_TITLE) | EVENT_FIELD(F_ALARM) | EVENT_FIELD(F_START) | EVENT_FIELD(F_STOP))
+
+static time_t
+_mktime(int32_t const y, uint const m, uint const d, uint const hh, uint const mm, uint const ss)
+{
+    struct tm tm = {
+        .tm_year = y - 1900, .tm_mon = m - 1, .tm_mday = d,
+        .tm_hour = hh, .tm_min = mm, .tm_sec = ss,
+        .tm_isdst = -1  // let mktime figure out if DST applies
+    };
+    return mktime(&tm);
+}
+
+// Seconds that local time is ahead of UTC on local `day` (y-m-d).  Cached, because a
+// payload only spans a few days.  When DST starts or ends on that day, or at the
+// midnight around it, returns false so the caller falls back to mktime().
+static bool
+_day_offset(calendar_json_t * const p, int32_t const day, int32_t const y, uint const m, uint const d, int32_t * const offset)
+{
+    calendar_json_day_t * const entry = &p->days[(uint32_t)day % CALENDAR_JSON_DAYS];
+    if (!entry->valid || entry->day != day) {
+        entry->day = day;
+        if (p->tz) {
+            // the offset holds from before the day before, until after the day after,
+            // so it doesn't matter that `midnight` is off by the offset itself
+            time_t const midnight = (time_t)day * 86400;
+            time_t since, until;
+            entry->offset = tz_lookup(p->tz, midnight, &since, &until, NULL);
+            entry->transition = since > midnight - 2 * 86400 || until < midnight + 3 * 86400;
+        } else {
+            // mktime() normalizes the out-of-range day of the month
+            time_t const prev = _mktime(y, m, d - 1, 0, 0, 0);
+            time_t const midnight = _mktime(y, m, d, 0, 0, 0);
+            time_t const next = _mktime(y, m, d + 1, 0, 0, 0);
+            entry->offset = (int64_t)day * 86400 - midnight;
+            entry->transition = midnight - prev != 86400 || next - midnight != 86400;
+        }
+        entry->valid = true;
+    }
+    *offset = entry->offset;
+    return !entry->transition;
+}
+
+static bool
+_digits(char const * const str, uint const len, uint * const value)
+{
+    *value = 0;
+    for (uint ii = 0; ii < len; ii++) {
+        if (str[ii] < '0' || str[ii] > '9') {
+            return false;
+        }
+        *value = *value * 10 + (str[ii] - '0');
+    }
+    return true;
+}
+
+// "YYYY-MM-DD HH:MM:SS" in local time, to seconds since the epoch, or 0 when malformed.
+// Gives the same result as strptime() with mktime() for tm_isdst -1, but only calls
+// mktime() for days with a DST transition, and without `tz` also for the first time
+// stamp on a day.
+static time_t
+_str2time(calendar_json_t * const p, char const * const str)
+{
+    uint y, m, d, hh, mm, ss;
+    if (strlen(str) != 19 || str[4] != '-' || str[7] != '-' || str[10] != ' ' || str[13] != ':' || str[16] != ':' ||
+        !_digits(str, 4, &y) || !_digits(str + 5, 2, &m) || !_digits(str + 8, 2, &d) ||
+        !_digits(str + 11, 2, &hh) || !_digits(str + 14, 2, &mm) || !_digits(str + 17, 2, &ss) ||
+        m < 1 || m > 12 || d < 1 || d > 31 || hh > 23 || mm > 59 || ss > 60) {
+        return 0;
+    }
+    int32_t const day = tz_days_from_civil(y, m, 1) + d - 1;  // like mktime(), April 31 is May 1
+    int32_t offset;
+    if (!_day_offset(p, day, y, m, d, &offset)) {
+        return _mktime(y, m, d, hh, mm, ss);
+    }
+    return (time_t)day * 86400 + hh * 3600 + mm * 60 + ss - offset;
+}
+
+static bool
+_is_space(char const c)
+{
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+static bool
+_is_literal(char const c)
+{
+    return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') || c == '-' || c == '+' || c == '.' || c == 'E';
+}
+
+static void
+_put(calendar_json_t * const p, char const c)
+{
+    switch (p->field) {
+        case F_KEY:
+            if (p->key_len < CALENDAR_JSON_KEY_LEN - 1) {
+                p->key[p->key_len++] = c;
+            } else {
+                p->key_len = CALENDAR_JSON_KEY_LEN;  // too long to match
+            }
+            break;
+        case F_TIME:
+        case F_ALARM:
+        case F_START:
+        case F_STOP:
+            if (p->time_len < CALENDAR_JSON_TIME_LEN - 1) {
+                p->time_str[p->time_len++] = c;
+            }
+            break;
+        case F_PUSHID:
+        case F_HASH:
+        case F_TITLE:
+            if (p->arena_len < p->arena_size - 1) {
+                p->arena[p->arena_len++] = c;
+            } else {
+                p->str_overflow = true;
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+static void
+_put_code_point(calendar_json_t * const p, uint32_t const cp)
+{
+    if (cp < 0x80) {
+        _put(p, cp);
+    } else if (cp < 0x800) {
+        _put(p, 0xC0 | (cp >> 6));
+        _put(p, 0x80 | (cp & 0x3F));
+    } else if (cp < 0x10000) {
+        _put(p, 0xE0 | (cp >> 12));
+        _put(p, 0x80 | ((cp >> 6) & 0x3F));
+        _put(p, 0x80 | (cp & 0x3F));
+    } else {
+        _put(p, 0xF0 | (cp >> 18));
+        _put(p, 0x80 | ((cp >> 12) & 0x3F));
+        _put(p, 0x80 | ((cp >> 6) & 0x3F));
+        _put(p, 0x80 | (cp & 0x3F));
+    }
+}
+
+// a high surrogate that is not followed by a low one
+static void
+_flush_surrogate(calendar_json_t * const p)
+{
+    if (p->high_surrogate) {
+        _put_code_point(p, 0xFFFD);
+        p->high_surrogate = 0;
+    }
+}
+
+static void
+_value_end(calendar_json_t * const p)
+{
+    p->field = F_NONE;
+    p->state = p->depth ? S_AFTER_VALUE : S_DONE;
+}
+
+static void
+_string_begin(calendar_json_t * const p)
+{
+    p->time_len = 0;
+    p->str_start = p->arena_len;
+    p->str_overflow = false;
+    p->high_surrogate = 0;
+    p->state = S_STRING;
+}
+
+static void
+_string_end(calendar_json_t * const p)
+{
+    _flush_surrogate(p);
+    calendar_json_event_t * const event = &p->events[p->events_len];
+    field_t const field = p->field;
+    switch (field) {
+        case F_KEY:
+            p->key[p->key_len < CALENDAR_JSON_KEY_LEN ? p->key_len : 0] = '\0';
+            p->state = S_COLON;
+            return;
+        case F_TIME:
+        case F_ALARM:
+        case F_START:
+        case F_STOP: {
+            p->time_str[p->time_len] = '\0';
+            time_t const t = _str2time(p, p->time_str);
+            if (t) {
+                if (field == F_TIME) {
+                    p->time = t;
+                } else {
+                    *(field == F_ALARM ? &event->alarm : field == F_START ? &event->start : &event->stop) = t;
+                    p->event_fields |= EVENT_FIELD(field);
+                }
+            }
+            break;
+        }
+        case F_PUSHID:
+        case F_HASH:
+        case F_TITLE:
+            if (p->str_overflow) {
+                p->arena_len = p->str_start;
+                break;
+            }
+            p->arena[p->arena_len++] = '\0';
+            if (field == F_PUSHID) {
+                p->pushId = p->arena + p->str_start;
+            } else if (field == F_HASH) {
+                p->hash = p->arena + p->str_start;
+            } else {
+                event->title = p->arena + p->str_start;
+                p->event_fields |= EVENT_FIELD(field);
+            }
+            break;
+        default:
+            break;
+    }
+    _value_end(p);
+}
+
+// what the value after this key is for
+static field_t
+_key2field(calendar_json_t const * const p)
+{
+    if (p->depth == 1) {
+        if (strcmp(p->key, "time") == 0) return F_TIME;
+        if (strcmp(p->key, "pushId") == 0) return F_PUSHID;
+        if (strcmp(p->key, "hash") == 0) return F_HASH;
+        if (strcmp(p->key, "events") == 0) return F_EVENTS;
+    } else if (p->depth == 3 && p->in_event) {
+        if (strcmp(p->key, "title") == 0) return F_TITLE;
+        if (strcmp(p->key, "alarm") == 0) return F_ALARM;
+        if (strcmp(p->key, "start") == 0) return F_START;
+        if (strcmp(p->key, "stop") == 0) return F_STOP;
+    }
+    return F_NONE;
+}
+
+static void
+_open(calendar_json_t * const p, char const c)
+{
+    if (p->depth == CALENDAR_JSON_DEPTH) {
+        p->state = S_ERROR;
+        return;
+    }
+    field_t const field = p->field;
+    p->stack[p->depth++] = c;
+    p->field = F_NONE;
+    if (c == '{') {
+        if (p->in_events && p->depth == 3) {  // an event
+            p->in_event = p->events_len < p->events_max;
+            p->event_fields = 0;
+            if (p->in_event) {
+                memset(&p->events[p->events_len], 0, sizeof(calendar_json_event_t));
+            } else {
+                p->events_dropped++;
+            }
+        }
+        p->state = S_KEY_OR_CLOSE;
+    } else {
+        if (field == F_EVENTS && p->depth == 2) {
+            p->in_events = true;
+        }
+        p->state = S_VALUE_OR_CLOSE;
+    }
+}
+
+static void
+_close(calendar_json_t * const p, char const c)
+{
+    if (p->depth == 0 || p->stack[p->depth - 1] != (c == '}' ? '{' : '[')) {
+        p->state = S_ERROR;
+        return;
+    }
+    p->depth--;
+    if (c == '}' && p->in_events && p->depth == 2 && p->in_event) {
+        if ((p->event_fields & EVENT_FIELDS) == EVENT_FIELDS) {
+            p->events_len++;
+        } else {
+            p->events_dropped++;
+        }
+        p->in_event = false;
+    }
+    if (c == ']' && p->in_events && p->depth == 1) {
+        p->in_events = false;
+    }
+    _value_end(p);
+}
+
+static void
+_value_begin(calendar_json_t * const p, char const c)
+{
+    if (p->depth == 0 && c != '{') {
+        p->state = S_ERROR;  // the root must be an object
+        return;
+    }
+    if (c == '"') {
+        if (p->field == F_EVENTS) {
+            p->field = F_NONE;
+        }
+        _string_begin(p);
+    } else if (c == '{' || c == '[') {
+        _open(p, c);
+    } else if (c == '-' || (c >= '0' && c <= '9') || c == 't' || c == 'f' || c == 'n') {
+        p->state = S_LITERAL;
+    } else {
+        p->state = S_ERROR;
+    }
+}
+
+static int
+_hex(char const c)
+{
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+void
+calendar_json_init(calendar_json_t * const p, calendar_json_event_t * const events, uint const events_max, char * const arena, size_t const arena_size, tz_t * const tz)
+{
+    memset(p, 0, sizeof(calendar_json_t));
+    p->tz = tz;
+    p->events = events;
+    p->events_max = events_max;
+    p->arena = arena;
+    p->arena_size = arena_size;
+    p->state = S_VALUE;
+}
+
+calendar_json_status_t
+calendar_json_feed(calendar_json_t * const p, char const * const chunk, size_t const len)
+{
+    size_t ii = 0;
+    while (ii < len && p->state != S_ERROR) {
+        char const c = chunk[ii];
+        switch ((state_t)p->state) {
+            case S_VALUE:
+                if (!_is_space(c)) {
+                    _value_begin(p, c);
+                }
+                break;
+            case S_VALUE_OR_CLOSE:
+                if (c == ']') {
+                    _close(p, c);
+                } else if (!_is_space(c)) {
+                    _value_begin(p, c);
+                }
+                break;
+            case S_KEY_OR_CLOSE:
+            case S_KEY:
+                if (c == '"') {
+                    p->field = F_KEY;
+                    p->key_len = 0;
+                    _string_begin(p);
+                } else if (c == '}' && p->state == S_KEY_OR_CLOSE) {
+                    _close(p, c);
+                } else if (!_is_space(c)) {
+                    p->state = S_ERROR;
+                }
+                break;
+            case S_COLON:
+                if (c == ':') {
+                    p->field = _key2field(p);
+                    p->state = S_VALUE;
+                } else if (!_is_space(c)) {
+                    p->state = S_ERROR;
+                }
+                break;
+            case S_AFTER_VALUE:
+                if (c == ',') {
+                    p->state = (p->stack[p->depth - 1] == '{') ? S_KEY : S_VALUE;
+                } else if (c == '}' || c == ']') {
+                    _close(p, c);
+                } else if (!_is_space(c)) {
+                    p->state = S_ERROR;
+                }
+                break;
+            case S_STRING:
+                if (c == '"') {
+                    _string_end(p);
+                } else if (c == '\\') {
+                    p->state = S_ESCAPE;
+                } else if ((unsigned char)c < 0x20) {
+                    p->state = S_ERROR;
+                } else {
+                    _flush_surrogate(p);
+                    _put(p, c);
+                }
+                break;
+            case S_ESCAPE: {
+                char const * const from = "\"\\/bfnrt";
+                char const * const to = "\"\\/\b\f\n\r\t";
+                char const * const esc = strchr(from, c);
+                if (c == 'u') {
+                    p->hex_cnt = 0;
+                    p->code_point = 0;
+                    p->state = S_UNICODE;
+                } else if (c && esc) {
+                    _flush_surrogate(p);
+                    _put(p, to[esc - from]);
+                    p->state = S_STRING;
+                } else {
+                    p->state = S_ERROR;
+                }
+                break;
+            }
+            case S_UNICODE: {
+                int const h = _hex(c);
+                if (h < 0) {
+                    p->state = S_ERROR;
+                    break;
+                }
+                p->code_point = (p->code_point << 4) | h;
+                if (++p->hex_cnt < 4) {
+                    break;
+                }
+                uint32_t const cp = p->code_point;
+                if (cp >= 0xDC00 && cp <= 0xDFFF && p->high_surrogate) {
+                    _put_code_point(p, 0x10000 + ((p->high_surrogate - 0xD800) << 10) + (cp - 0xDC00));
+                    p->high_surrogate = 0;
+                } else {
+                    _flush_surrogate(p);
+                    if (cp >= 0xD800 && cp <= 0xDBFF) {
+                        p->high_surrogate = cp;
+                    } else {
+                        _put_code_point(p, (cp >= 0xDC00 && cp <= 0xDFFF) ? 0xFFFD : cp);
+                    }
+                }
+                p->state = S_STRING;
+                break;
+            }
+            case S_LITERAL:
+                if (!_is_literal(c)) {
+                    _value_end(p);
+                    continue;  // the character after the literal still needs parsing
+                }
+                break;
+            case S_DONE:
+                if (!_is_space(c)) {
+                    p->state = S_ERROR;
+                }
+                break;
+            case S_ERROR:
+                break;
+        }
+        ii++;
+    }
+    return calendar_json_status(p);
+}
+
+calendar_json_status_t
+calendar_json_status(calendar_json_t const * const p)
+{
+    switch ((state_t)p->state) {
+        case S_DONE: return CALENDAR_JSON_DONE;
+        case S_ERROR: return CALENDAR_JSON_ERROR;
+        default: return CALENDAR_JSON_MORE;
+    }
+}
+
+void
+calendar_json_payload_init(calendar_json_payload_t * const payload, tz_t * const tz)
+{
+    calendar_json_init(&payload->json, payload->events, CALENDAR_JSON_EVENTS_MAX, payload->arena, sizeof(payload->arena), tz);
+}
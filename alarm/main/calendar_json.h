@@ -0,0 +1,79 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <time.h>
+#include <sys/types.h>
+#include "tz.h"
+
+#define CALENDAR_JSON_DEPTH (8)      // max nesting of objects and arrays
+#define CALENDAR_JSON_KEY_LEN (16)   // longer keys are skipped
+#define CALENDAR_JSON_TIME_LEN (24)  // "YYYY-MM-DD HH:MM:SS"
+#define CALENDAR_JSON_DAYS (4)       // local days whose UTC offset is cached
+#define CALENDAR_JSON_EVENTS_MAX (32)    // as many as the schedule holds
+#define CALENDAR_JSON_ARENA_SIZE (2048)  // pushId and the event titles in one payload
+
+typedef enum calendar_json_status_t {
+    CALENDAR_JSON_MORE,   // feed the next chunk
+    CALENDAR_JSON_DONE,   // the root object is complete
+    CALENDAR_JSON_ERROR   // not JSON, or not an object
+} calendar_json_status_t;
+
+typedef struct calendar_json_event_t {
+    time_t alarm, start, stop;
+    char const * title;  // in the arena
+} calendar_json_event_t;
+
+typedef struct calendar_json_day_t {
+    int32_t day;      // days since 1970-01-01, local
+    int32_t offset;   // seconds that local time is ahead of UTC
+    bool valid;
+    bool transition;  // DST starts or ends close by, use mktime()
+} calendar_json_day_t;
+
+typedef struct calendar_json_t {
+    // result
+    time_t time;                    // 0 when missing
+    char const * pushId;            // in the arena, NULL when missing
+    char const * hash;              // of the events, in the arena, NULL when missing
+    calendar_json_event_t * events; // supplied by the caller
+    uint events_len;
+    uint events_dropped;            // didn't fit, or had missing fields
+
+    // where the strings go
+    uint events_max;
+    char * arena;
+    size_t arena_size, arena_len;
+
+    // parser state
+    uint8_t state;
+    uint8_t depth;
+    char stack[CALENDAR_JSON_DEPTH];  // '{' or '[' for each open container
+    uint8_t field;                    // what the string being parsed, or the next value, is for
+    bool in_events;                   // inside the root's "events" array
+    bool in_event;                    // inside an object in "events" that has a record
+    uint8_t event_fields;             // fields seen in the current event
+    uint8_t hex_cnt;
+    uint32_t code_point, high_surrogate;
+    size_t str_start;                 // arena offset of the string being parsed
+    bool str_overflow;
+    uint8_t key_len, time_len;
+    char key[CALENDAR_JSON_KEY_LEN];
+    char time_str[CALENDAR_JSON_TIME_LEN];
+
+    tz_t * tz;                                      // time zone of the time stamps, NULL to use mktime()
+    calendar_json_day_t days[CALENDAR_JSON_DAYS];  // UTC offset of recently seen local days
+} calendar_json_t;
+
+// a parser with its own records and arena, so the result can be handed to another
+// task in one block
+typedef struct calendar_json_payload_t {
+    calendar_json_t json;
+    calendar_json_event_t events[CALENDAR_JSON_EVENTS_MAX];
+    char arena[CALENDAR_JSON_ARENA_SIZE];
+} calendar_json_payload_t;
+
+void calendar_json_init(calendar_json_t * const p, calendar_json_event_t * const events, uint const events_max, char * const arena, size_t const arena_size, tz_t * const tz);
+calendar_json_status_t calendar_json_feed(calendar_json_t * const p, char const * const chunk, size_t const len);
+calendar_json_status_t calendar_json_status(calendar_json_t const * const p);
+void calendar_json_payload_init(calendar_json_payload_t * const payload, tz_t * const tz);
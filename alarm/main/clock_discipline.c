@@ -0,0 +1,95 @@
+/**
+ * @brief clock_discipline, keeps the wall clock in step with the time in the GAS response
+ *
+ * © Copyright 2016, 2022, Sander and Coert Vonk
+ *
+ * This file is part of CALalarm.
+ *
+ * CALalarm is free software: you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * CALalarm is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with CALalarm.
+ * If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ **/
+
+#include <string.h>
+
+#include "clock_discipline.h"
+
+// The script stamps its response somewhere between the request going out and the
+// response coming back, and truncates it to the second.  The best estimate of the
+// true time is therefore the stamp plus half a second, at the midpoint of the round
+// trip.  Only the first sync, and offsets beyond CLOCK_DISCIPLINE_STEP_US, step the
+// clock.  Otherwise half the offset is returned to be slewed, so the time never jumps,
+// and the jitter of the estimate is smoothed.
+//
+// The drift of the oscillator follows from all the corrections since the last step,
+// divided by the time they span.  That baseline grows with each sync, so the error of
+// the individual time stamps averages out.  clock_discipline_tick() hands out the
+// correction for the drift between syncs.
+// Only depends on the C library, so it can be exercised on a host.
+
+void
+clock_discipline_init(clock_discipline_t * const cd)
+{
+    memset(cd, 0, sizeof(clock_discipline_t));
+}
+
+// Returns the correction to apply to the wall clock [us].  Sets `step` when it must be
+// stepped, otherwise it should be slewed.
+int64_t
+clock_discipline_sync(clock_discipline_t * const cd, clock_discipline_sample_t const * const sample, bool * const step)
+{
+    int64_t const rtt_us = sample->recv_us > sample->send_us ? sample->recv_us - sample->send_us : 0;
+    int64_t const midpoint_wall_us = sample->wall_us - rtt_us / 2;
+    int64_t const offset_us = (int64_t)sample->server * 1000000 + 500000 - midpoint_wall_us;
+    cd->offset_us = offset_us;
+    cd->rtt_us = rtt_us;
+
+    // the drift that accrued since the last tick is part of the offset
+    cd->tick_us = sample->recv_us;
+    cd->tick_rem = 0;
+
+    *step = !cd->synced || offset_us > CLOCK_DISCIPLINE_STEP_US || offset_us < -CLOCK_DISCIPLINE_STEP_US;
+    if (*step) {
+        cd->synced = true;
+        cd->base_us = sample->recv_us;
+        cd->applied_us = 0;
+        return offset_us;
+    }
+    int64_t const baseline_us = sample->recv_us - cd->base_us;
+    if (baseline_us >= CLOCK_DISCIPLINE_BASELINE_US) {
+        int64_t drift_ppb = (cd->applied_us + offset_us) * 1000000000 / baseline_us;
+        if (drift_ppb > CLOCK_DISCIPLINE_DRIFT_MAX_PPB) {
+            drift_ppb = CLOCK_DISCIPLINE_DRIFT_MAX_PPB;
+        } else if (drift_ppb < -CLOCK_DISCIPLINE_DRIFT_MAX_PPB) {
+            drift_ppb = -CLOCK_DISCIPLINE_DRIFT_MAX_PPB;
+        }
+        cd->drift_ppb = drift_ppb;
+    }
+    int64_t const correction_us = offset_us / 2;  // averages out some of the jitter
+    cd->applied_us += correction_us;
+    return correction_us;
+}
+
+// Correction for the drift since the previous call [us], to be slewed.
+int64_t
+clock_discipline_tick(clock_discipline_t * const cd, int64_t const now_us)
+{
+    if (!cd->synced || now_us <= cd->tick_us) {
+        return 0;
+    }
+    int64_t const owed = (int64_t)cd->drift_ppb * (now_us - cd->tick_us) + cd->tick_rem;
+    int64_t const correction_us = owed / 1000000000;
+    cd->tick_rem = owed - correction_us * 1000000000;
+    cd->tick_us = now_us;
+    cd->applied_us += correction_us;
+    return correction_us;
+}
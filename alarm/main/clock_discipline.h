@@ -0,0 +1,30 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+#include <time.h>
+
+#define CLOCK_DISCIPLINE_STEP_US (60 * 1000000LL)          // larger offsets are stepped, not slewed
+#define CLOCK_DISCIPLINE_BASELINE_US (20 * 60 * 1000000LL)  // before the drift is estimated
+#define CLOCK_DISCIPLINE_DRIFT_MAX_PPB (500000)             // more than any crystal drifts
+
+typedef struct clock_discipline_sample_t {
+    time_t server;     // time stamp in the response, truncated to the second
+    int64_t send_us;   // monotonic, when the request went out
+    int64_t recv_us;   // monotonic, when the response came in
+    int64_t wall_us;   // wall clock at `recv_us`
+} clock_discipline_sample_t;
+
+typedef struct clock_discipline_t {
+    bool synced;
+    int64_t base_us;     // monotonic time of the last step, where the drift is measured from
+    int64_t applied_us;  // corrections since then
+    int32_t drift_ppb;   // how much the wall clock runs slow [ns/s]
+    int64_t tick_us;     // monotonic time drift was last compensated for
+    int64_t tick_rem;    // sub-microsecond remainder [us * 1e9]
+    int64_t offset_us;   // last measured offset, for logging
+    int64_t rtt_us;      // last round trip time, for logging
+} clock_discipline_t;
+
+void clock_discipline_init(clock_discipline_t * const cd);
+int64_t clock_discipline_sync(clock_discipline_t * const cd, clock_discipline_sample_t const * const sample, bool * const step);
+int64_t clock_discipline_tick(clock_discipline_t * const cd, int64_t const now_us);
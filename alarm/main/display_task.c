@@ -1,5 +1,5 @@
 /**
- * @brief display_task, received JSON, parses and drive LED circle accordingly
+ * @brief display_task, receives the parsed calendar and drives the display accordingly
  *
  * © Copyright 2016, 2022, Sander and Coert Vonk
  * 
@@ -25,16 +25,25 @@
 #include <sys/time.h>
 #include <string.h>
 #include <esp_log.h>
+#include <esp_heap_caps.h>
+#include <esp_timer.h>
 #include <freertos/FreeRTOS.h>
 #include <freertos/task.h>
 #include <driver/rmt.h>
-#include <cJSON.h>
 #include <driver/adc.h>
 #include <soc/adc_channel.h>
 
 #include "display_task.h"
 
 #include "ipc/ipc.h"
+#include "ambient_light.h"
+#include "schedule.h"
+#include "calendar_json.h"
+#include "tz.h"
+#include "msg_pool.h"
+#include "alarm_timer.h"
+#include "oled_flush_task.h"
+#include "oled_view.h"
 #include "ssd1306.h"
 #include "font8x8_basic.h"
 
@@ -51,43 +60,40 @@
 
 static char const * const TAG = "display_task";
 static ipc_t * _ipc;
+static tz_t _tz;  // compiled from the TZ environment variable
+
+#define CALENDAR_PUSHID_LEN (64)
 
 typedef struct {
-    bool valid;
-    char * title;
-    char * pushId;
-    time_t alarm, start, stop;
-} PACK8 event_t;
+    schedule_t schedule;  // events in the next 48 hours
+    char pushId[CALENDAR_PUSHID_LEN];  // empty when push notifications are not active
+} calendar_t;
 
-void
-sendToDisplay(toDisplayMsgType_t const dataType, char const * const data, ipc_t const * const ipc)
+// hands `block` from msg_pool to the display task, that returns it; false when dropped
+bool
+sendBlockToDisplay(toDisplayMsgType_t const dataType, void * const block, ipc_t const * const ipc)
 {
     toDisplayMsg_t msg = {
         .dataType = dataType,
-        .data = strdup(data)
+        .data = block
     };
-    assert(msg.data);
     if (xQueueSendToBack(ipc->toDisplayQ, &msg, 0) != pdPASS) {
         ESP_LOGE(TAG, "toDisplayQ full");
-        free(msg.data);
-    }
-}
-
-static time_t
-_str2time(char * str) {  // e.g. 2020-06-25T22:30:16.329Z
-    struct tm tm;
-    if (strptime(str, "%Y-%m-%d %H:%M:%S", &tm) == NULL) {
-        ESP_LOGE(TAG, "can't parse time (%s)", str);
-        return 0;
+        msg_pool_free(msg.data);
+        return false;
     }
-    return mktime(&tm);
+    return true;
 }
 
-static void
-_set_time(time_t const time)
+void
+sendToDisplay(toDisplayMsgType_t const dataType, char const * const data, ipc_t const * const ipc)
 {
-    struct timeval tv = { .tv_sec = time, .tv_usec = 0};
-    settimeofday(&tv, NULL);
+    char * const block = msg_pool_strdup(data);
+    if (!block) {
+        ESP_LOGE(TAG, "msg_pool has no block for %u bytes", (uint)strlen(data) + 1);
+        return;
+    }
+    (void)sendBlockToDisplay(dataType, block, ipc);
 }
 
 static time_t
@@ -96,84 +102,41 @@ _get_time(time_t * time_)
     return time(time_);
 }
 
+// https_client_task parsed the payload while it arrived
 static uint
-_json2event(char const * const serializedJson, time_t * const time, event_t * const event)
+_payload2calendar(calendar_json_payload_t const * const payload, time_t * const time, calendar_t * const calendar)
 {
-    event->valid = false;
+    calendar_json_t const * const json = &payload->json;
+    calendar_json_status_t const status = calendar_json_status(json);
 
-    uint len = 0;
-    if (serializedJson[0] != '{' || serializedJson[strlen(serializedJson)-1] != '}') {
-        ESP_LOGW(TAG, "first/last JSON chr ('%c' '%c'", serializedJson[0], serializedJson[strlen(serializedJson)-1]);
-        return len;
-    }
-    cJSON * const jsonRoot = cJSON_Parse(serializedJson);
-    if (jsonRoot->type != cJSON_Object) {
+    if (status != CALENDAR_JSON_DONE) {
         ESP_LOGE(TAG, "JSON err");
-        return 0;
     }
-    cJSON const *const jsonTime = cJSON_GetObjectItem(jsonRoot, "time");
-    if (!jsonTime || jsonTime->type != cJSON_String) {
+    if (!json->time) {
         ESP_LOGE(TAG, "JSON.time err");
         return 0;
     }
-    *time = _str2time(jsonTime->valuestring);
+    *time = json->time;
 
-    cJSON const *const jsonPushId = cJSON_GetObjectItem(jsonRoot, "pushId");
-    if (!jsonPushId || jsonPushId->type != cJSON_String) {
+    strlcpy(calendar->pushId, json->pushId ? json->pushId : "", sizeof(calendar->pushId));
+    if (!json->pushId) {
         ESP_LOGW(TAG, "JSON.pushId is missing (or not a String)");
-        free(event->pushId);
-        event->pushId = NULL;
-    } else {
-        free(event->pushId);
-        event->pushId = strdup(jsonPushId->valuestring);
     }
-
-    cJSON const *const jsonEvents = cJSON_GetObjectItem(jsonRoot, "events");
-    if (!jsonEvents || jsonEvents->type != cJSON_Array) {
-        ESP_LOGE(TAG, "JSON.events err");
-        return 0;
+    if (json->events_dropped) {
+        ESP_LOGW(TAG, "JSON.events dropped %u", json->events_dropped);
     }
 
-    if (cJSON_GetArraySize(jsonEvents) > 0) {
-
-        cJSON const *const jsonEvent = cJSON_GetArrayItem(jsonEvents, 0);
-        if (!jsonEvent || jsonEvent->type != cJSON_Object) {
-            ESP_LOGE(TAG, "JSON.events[0] err");
-            return 0;
-        }
-
-        cJSON const *const jsonTitleObj = cJSON_GetObjectItem(jsonEvent, "title");
-        cJSON const *const jsonAlarmObj = cJSON_GetObjectItem(jsonEvent, "alarm");
-        cJSON const *const jsonStartObj = cJSON_GetObjectItem(jsonEvent, "start");
-        cJSON const *const jsonStopObj = cJSON_GetObjectItem(jsonEvent, "stop");
-
-        if (!jsonTitleObj || jsonTitleObj->type != cJSON_String) {
-            ESP_LOGE(TAG, "JSON.event[0].title err");
-            return 0;
-        }
-        if (!jsonAlarmObj || jsonAlarmObj->type != cJSON_String) {
-            ESP_LOGE(TAG, "JSON.event[0].alarm err");
-            return 0;
-        }
-        if (!jsonStartObj || jsonStartObj->type != cJSON_String) {
-            ESP_LOGE(TAG, "JSON.event[0].start err");
-            return 0;
+    // the payload carries the whole window, events that are no longer in it are dropped,
+    // unless the payload was cut short
+    schedule_begin(&calendar->schedule);
+    for (uint ii = 0; ii < json->events_len; ii++) {
+        calendar_json_event_t const * const event = &json->events[ii];
+        if (!schedule_add(&calendar->schedule, event->title, event->alarm, event->start, event->stop, *time)) {
+            ESP_LOGW(TAG, "schedule full, dropped \"%s\"", event->title);
         }
-        if (!jsonStopObj || jsonStopObj->type != cJSON_String) {
-            ESP_LOGE(TAG, "JSON.event[0].end err");
-            return 0;
-        }
-
-        free(event->title);
-        event->valid = true;
-        event->title = strdup(jsonTitleObj->valuestring);
-        event->alarm = _str2time(jsonAlarmObj->valuestring);
-        event->start = _str2time(jsonStartObj->valuestring);
-        event->stop = _str2time(jsonStopObj->valuestring);
     }
-
-    cJSON_Delete(jsonRoot);
-    return len;
+    schedule_end(&calendar->schedule, status == CALENDAR_JSON_DONE && !json->events_dropped);
+    return json->events_len;
 }
 
 void
@@ -183,89 +146,121 @@ _oled_init(SSD1306_t * const dev)
 	ssd1306_init(dev, 128, 32);
 	ssd1306_clear_screen(dev, false);
 	ssd1306_contrast(dev, 0xff);
+    oled_flush_start(dev);  // from here on, `dev` is only the back buffer that we compose in
+}
+
+static int
+_read_ambient_light(void)
+{
+    uint const oversample = 16;  // averages out the ADC noise
+
+    int sum = 0;
+    for (uint ii = 0; ii < oversample; ii++) {
+        sum += adc1_get_raw(ADC1_CHANNEL);
+    }
+    return sum / oversample;
 }
 
 static void
-_oled_set_brightness(SSD1306_t * const dev, int const brightness)
+_oled_set_brightness(int const brightness)
 {
     //ESP_LOGI(TAG, "brightness=%u", brightness);
-    ssd1306_contrast(dev, brightness);  // 2nd arg is uint8_t
+    oled_flush_contrast(brightness);  // clamped to uint8_t
 }
 
+#define AMBIENT_LIGHT_PERIOD_US (10 * 1000000LL)  // the filter and hysteresis in ambient_light.c are tuned for this
+
+// The display loop only wakes once a minute, too slow to follow a light that is
+// switched on or off.  So the sensor is sampled from its own timer.
 static void
-_oled_set_status(SSD1306_t * const dev, char const * const src, bool const show_link)
+_ambient_light_cb(void * arg)
 {
-
-    char str[18];
-    if (show_link) {
-        char const * const link_symb = " \x03\x04";
-        snprintf(str, sizeof(str), "%-13s", src);  // pad to 13 characters
-        strcpy(str + 13, link_symb);
-    } else {
-        snprintf(str, sizeof(str), "%-16s", src);  //  pad to 16 characters
+    ambient_light_t * const ambient_light = arg;
+    int contrast;
+    if (ambient_light_update(ambient_light, _read_ambient_light(), &contrast)) {  // only when perceptible
+        _oled_set_brightness(contrast);
     }
-    ssd1306_clear_line(dev, 3, false);
-    ssd1306_display_text(dev, 3, (char *)str, strlen(str), false);
 }
 
 static void
-_oled_set_ampm(SSD1306_t * const dev, bool const is_pm)
+_ambient_light_init(void)
 {
-    char str[] = "               A";
-    if (is_pm) {
-        str[15] = 'P';
-    }
-    ssd1306_display_text(dev, 0, str, strlen(str), false);
-    str[15] = 'M';
-    ssd1306_display_text(dev, 1, str, strlen(str), false);
+    ESP_ERROR_CHECK(adc1_config_channel_atten(ADC1_CHANNEL, ADC_ATTEN_DB_0));  // measures 0.10 to 0.95 Volts
+    static ambient_light_t ambient_light;  // owned by the esp_timer task from here on
+    ambient_light_init(&ambient_light);
+    _ambient_light_cb(&ambient_light);
+
+    esp_timer_create_args_t const args = {
+        .callback = &_ambient_light_cb,
+        .arg = &ambient_light,
+        .name = "ambient_light",
+    };
+    esp_timer_handle_t timer;
+    ESP_ERROR_CHECK(esp_timer_create(&args, &timer));
+    ESP_ERROR_CHECK(esp_timer_start_periodic(timer, AMBIENT_LIGHT_PERIOD_US));
 }
 
+// the status line shows the next alarm
 static void
-_oled_update(SSD1306_t * const dev, time_t const now, event_t const * const event)
+_oled_view_alarm(oled_view_t * const view, calendar_t const * const calendar)
 {
-    // show time
-    {
-        struct tm nowTm;
-        localtime_r(&now, &nowTm);
-
-        // jump through hoops for 12-hour time
-        uint8_t const hrs = (nowTm.tm_hour % 12 == 0) ? 12 : nowTm.tm_hour % 12;
-        uint8_t const min = nowTm.tm_min;
-        _oled_set_ampm(dev, nowTm.tm_hour >= 12);
-
-        char str[6];
-        snprintf(str, sizeof(str), "%2d:%02d", hrs % 100, min % 100);  // work around `-Wformat-truncation`
-        ssd1306_display_text_x3(dev, 0, str, strlen(str), false);
-    }
-
-    // show status
-    char status[17];
-    if (event->valid) {
+    char status[OLED_VIEW_STATUS_LEN];
+    schedule_event_t const * const next = schedule_next_alarm(&calendar->schedule);
+    if (next) {
         struct tm alarmTm;
-        localtime_r(&event->alarm, &alarmTm);
+        tz_localtime(&_tz, next->alarm, &alarmTm);
         uint8_t const hrs = (alarmTm.tm_hour % 12 == 0) ? 12 : alarmTm.tm_hour % 12;
         uint8_t const min = alarmTm.tm_min;
-        snprintf(status, ARRAY_SIZE(status), "%d:%02d %-10s", hrs % 100, min % 100, event->title);  // work around `-Wformat-truncation`
+        snprintf(status, ARRAY_SIZE(status), "%d:%02d %s", hrs % 100, min % 100, schedule_title(&calendar->schedule, next));  // work around `-Wformat-truncation`
     } else {
         strcpy(status, "no alarm set");
     }
-    _oled_set_status(dev, status, event->pushId);
+    oled_view_set_status(view, status, calendar->pushId[0]);
 }
 
-void
-_buzzer_update(time_t const now, event_t const * const event, ipc_t * ipc)
+// compose the whole frame, and hand it to oled_flush_task, that only sends the columns that changed
+static void
+_oled_render(SSD1306_t * const dev, oled_view_t const * const view)
 {
-    time_t last = 0;
-    struct tm nowTm, alarmTm;
-    localtime_r(&now, &nowTm);
-    localtime_r(&event->alarm, &alarmTm);
-
-    if (event->valid && nowTm.tm_hour == alarmTm.tm_hour && nowTm.tm_min == alarmTm.tm_min) {
-        if (difftime(last, now) > 60) {  //  make sure it doesn't go off multiple times in same minute
-            sendToBuzzer(TO_BUZZER_MSGTYPE_START, ipc);
-            last = now;
-        }
+    oled_flush_swap(dev, oled_view_render(dev, view));
+}
+
+// fragmentation shows as a largest free block that shrinks while the free size doesn't
+static void
+_log_heap(void)
+{
+    msg_pool_stats_t pool;
+    msg_pool_get_stats(&pool);
+    ESP_LOGI(TAG, "heap free %u, min free %u, largest block %u; msg_pool small %u (max %u), large %u (max %u), failed %u, foreign %u",
+             (uint)heap_caps_get_free_size(MALLOC_CAP_8BIT), (uint)heap_caps_get_minimum_free_size(MALLOC_CAP_8BIT),
+             (uint)heap_caps_get_largest_free_block(MALLOC_CAP_8BIT),
+             pool.small_used, pool.small_max, pool.large_used, pool.large_max, pool.failed, pool.foreign);
+}
+
+// Ticks until the next minute boundary or the alarm, whichever comes first.  Rounded
+// up and one tick extra, because a timeout of n ticks may end up to a tick early.
+static TickType_t
+_ticks_until_deadline(schedule_t const * const schedule)
+{
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    int64_t const now_ms = (int64_t)tv.tv_sec * 1000 + tv.tv_usec / 1000;
+    int64_t const ms = schedule_ms_until_deadline(schedule, now_ms);
+    return (ms + portTICK_PERIOD_MS - 1) / portTICK_PERIOD_MS + 1;
+}
+
+// retire the alarms that went off (or that the clock jumped past), and arm the timer
+// for the next one; also corrects for the drift between the wall clock and the timer
+static void
+_alarm_update(time_t const now, schedule_t * const schedule)
+{
+    time_t const last_fired = alarm_timer_last_fired();
+    schedule_event_t const * next;
+    while ((next = schedule_next_alarm(schedule)) &&
+           (next->alarm <= last_fired || next->alarm <= now - ALARM_DEADLINE_GRACE_SEC)) {
+        schedule_pop_alarm(schedule);
     }
+    alarm_timer_arm(next ? next->alarm : 0);
 }
 
 void
@@ -273,40 +268,73 @@ display_task(void * ipc_void)
 {
     _ipc = ipc_void;
 
-    // init OLED display
-    SSD1306_t dev;
+    // init OLED display (static, because it holds two copies of the frame)
+    static SSD1306_t dev;
     _oled_init(&dev);
 
-    event_t event = {};
+    static calendar_t calendar = {};  // static, because of the size of the schedule
+    schedule_init(&calendar.schedule);
+    alarm_timer_init(_ipc);
+    if (!tz_init(&_tz, getenv("TZ"))) {
+        ESP_LOGE(TAG, "can't parse TZ, using UTC");
+    }
+    tz_clock_t clock = {};  // local time, carried forward from one minute to the next
     time_t now = 0;
-    time_t const loopInSec = 10;  // how often the while-loop runs [sec]
+    time_t const loopInSec = 10;  // how often the while-loop runs until the time is known [sec]
+    struct {
+        uint messages, deadlines;
+        time_t since;
+    } wakeups = {};
 
-    // init A/D converter
-    ESP_ERROR_CHECK(adc1_config_channel_atten(ADC1_CHANNEL, ADC_ATTEN_DB_0));  // measures 0.10 to 0.95 Volts
+    // init A/D converter, the ambient light sets the contrast
+    _ambient_light_init();
+
+    oled_view_t view = {};  // what the display shows
 
     while (1) {
 
+        // sleep until the minute changes, the alarm goes off, or a message arrives
+        TickType_t timeout = (TickType_t)(loopInSec * 1000 / portTICK_PERIOD_MS);
+        if (now) {
+            timeout = _ticks_until_deadline(&calendar.schedule);
+        }
         toDisplayMsg_t msg;
-        if (xQueueReceive(_ipc->toDisplayQ, &msg, (TickType_t)(loopInSec * 1000 / portTICK_PERIOD_MS)) == pdPASS) {
+        if (xQueueReceive(_ipc->toDisplayQ, &msg, timeout) == pdPASS) {
+            wakeups.messages++;
 
             switch(msg.dataType) {
-                case TO_DISPLAY_MSGTYPE_JSON:
-                    (void)_json2event(msg.data, &now, &event); // translate from serialized JSON `msg` to `event`
-                    _set_time(now);
+                case TO_DISPLAY_MSGTYPE_CALENDAR: {
+                    int64_t const start_us = esp_timer_get_time();
+                    uint const events = _payload2calendar(msg.data, &now, &calendar); // translate from the parsed `msg` to `calendar`
+                    ESP_LOGI(TAG, "applied %u events in %lld us", events, (long long)(esp_timer_get_time() - start_us));
+                    _get_time(&now);  // https_client_task already disciplined the clock
                     break;
+                }
                 case TO_DISPLAY_MSGTYPE_STATUS:
-                    _oled_set_status(&dev, msg.data, false);
+                    oled_view_set_status(&view, msg.data, false);
+                    _oled_render(&dev, &view);
                     break;
             }
-            free(msg.data);
+            msg_pool_free(msg.data);
         } else {
+            wakeups.deadlines++;
             _get_time(&now);
         }
+        if (now && !wakeups.since) {
+            wakeups.since = now;  // the first hour starts when the time is known
+        }
+        if (now && (now - wakeups.since >= 3600 || now < wakeups.since)) {
+            ESP_LOGI(TAG, "wakeups in the last hour: %u for messages, %u for deadlines", wakeups.messages, wakeups.deadlines);
+            _log_heap();
+            wakeups.messages = wakeups.deadlines = 0;
+            wakeups.since = now;
+        }
 
         if (now) {  // tod is initialized
-            _oled_update(&dev, now, &event);
-            _buzzer_update(now, &event, _ipc);
+            _alarm_update(now, &calendar.schedule);
+            oled_view_set_time(&view, tz_clock_advance(&_tz, &clock, now));
+            _oled_view_alarm(&view, &calendar);
+            _oled_render(&dev, &view);
         }
-        _oled_set_brightness(&dev, adc1_get_raw(ADC1_CHANNEL));
     }
-}
\ No newline at end of file
+}
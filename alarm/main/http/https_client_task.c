@@ -21,7 +21,9 @@
 
 #include <string.h>
 #include <stdlib.h>
+#include <sys/time.h>
 #include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
 #include <freertos/task.h>
 #include <freertos/queue.h>
 #include <esp_wifi.h>
@@ -33,68 +35,163 @@
 #include <esp_netif.h>
 #include <esp_tls.h>
 #include <esp_http_client.h>
+#include <esp_timer.h>
 #include <lwip/err.h>
 #include <lwip/sockets.h>
 #include <lwip/sys.h>
 #include <lwip/netdb.h>
 #include <lwip/dns.h>
-#include <cJSON.h>
 
 #include "https_client_task.h"
+#include "https_fetch.h"
 #include "../ipc/ipc.h"
+#include "../calendar_json.h"
+#include "../alarm_timer.h"
+#include "../clock_discipline.h"
+#include "../msg_pool.h"
+#include "../poll_schedule.h"
+#include "../tz.h"
 
 static const char * TAG = "https_client_task";
-static char * _data = NULL;
-static int _data_len = 0;
+static tz_t _tz;  // of the time stamps in the payload
+static poll_schedule_t _poll;
+
+#define PUSH_SERVICE_DURATION_S (60 * 60)  // max push notification service duration is 1 hr
+
+// The body is parsed chunk by chunk as it arrives, straight from the client's receive
+// buffer, into a block that is then handed to the display task.  So the payload is
+// never held as text, and it isn't limited by the size of the receive buffer.
+static struct {
+    calendar_json_payload_t * payload;  // NULL when not receiving a calendar
+    uint len;                           // bytes received
+    int64_t parse_us;                   // CPU time spent parsing them
+} _body;
+_Static_assert(sizeof(calendar_json_payload_t) <= MSG_POOL_LARGE_SIZE, "calendar doesn't fit in a msg_pool block");
+
+static struct {
+    SemaphoreHandle_t mutex;  // protects `cd`, the drift is compensated from the esp_timer task
+    esp_timer_handle_t timer;
+    clock_discipline_t cd;
+} _clock;
+
+#define CLOCK_DRIFT_PERIOD_US (60 * 1000000LL)
+
+// The script stamps the response to the first request, GAS then redirects to where
+// the response can be picked up.  So the stamp was made between `_fetch.send_us` and
+// `_fetch.recv_us`.
+static https_fetch_t _fetch;
 
 void
 sendToClient(toClientMsgType_t const dataType, char const * const data, ipc_t const * const ipc)
 {
     toClientMsg_t msg = {
         .dataType = dataType,
-        .data = strdup(data)
+        .data = msg_pool_strdup(data)
     };
-    assert(msg.data);
+    if (!msg.data) {
+        ESP_LOGE(TAG, "msg_pool has no block for %u bytes", (uint)strlen(data) + 1);
+        return;
+    }
     if (xQueueSendToBack(ipc->toClientQ, &msg, 0) != pdPASS) {
         ESP_LOGE(TAG, "toClientQ full");
-        free(msg.data);
+        msg_pool_free(msg.data);
     }
 }
 
-esp_err_t
-_http_event_handle(esp_http_client_event_t *evt)
+// the body is parsed as it arrives, into the block that receives it
+static void
+_body_cb(void * const ctx, char const * const data, int const len)
 {
-    // gets called twice in a row because of the redirect that GAS uses
-
-    if (evt->event_id == HTTP_EVENT_ON_DATA) {
-        // store data ptr and len here, because content_length returns -1
-        _data = evt->data;
-        _data_len = evt->data_len;
+    if (!_body.payload) {
+        return;
+    }
+    if (!data) {
+        calendar_json_payload_init(_body.payload, &_tz);
+        _body.len = 0;
+        _body.parse_us = 0;
+        return;
     }
-    return ESP_OK;
+    int64_t const start_us = esp_timer_get_time();
+    _body.len += len;
+    calendar_json_feed(&_body.payload->json, data, len);
+    _body.parse_us += esp_timer_get_time() - start_us;
 }
 
+// slew the wall clock by `us` on top of what is still being slewed
 static void
-_json2pushId(char const * const serializedJson, char * const pushId, uint const pushId_len)
+_clock_slew(int64_t const us)
 {
-    *pushId = '\0';
-    if (serializedJson[0] != '{' || serializedJson[strlen(serializedJson)-1] != '}') {
-        ESP_LOGW(TAG, "first/last JSON chr ('%c' '%c'", serializedJson[0], serializedJson[strlen(serializedJson)-1]);
-        return;
+    struct timeval outstanding;
+    adjtime(NULL, &outstanding);
+    int64_t const total_us = us + (int64_t)outstanding.tv_sec * 1000000 + outstanding.tv_usec;
+    struct timeval const delta = {
+        .tv_sec = total_us / 1000000,
+        .tv_usec = total_us % 1000000
+    };
+    adjtime(&delta, NULL);
+}
+
+static void
+_clock_drift_cb(void * unused)
+{
+    xSemaphoreTake(_clock.mutex, portMAX_DELAY);
+    int64_t const correction_us = clock_discipline_tick(&_clock.cd, esp_timer_get_time());
+    if (correction_us) {
+        _clock_slew(correction_us);
     }
+    xSemaphoreGive(_clock.mutex);
+}
 
-    cJSON * const jsonRoot = cJSON_Parse(serializedJson);
-    if (jsonRoot->type != cJSON_Object) {
-        ESP_LOGE(TAG, "JSON root is not an Object");
-        return;
+static void
+_clock_init(void)
+{
+    clock_discipline_init(&_clock.cd);
+    _clock.mutex = xSemaphoreCreateMutex();
+    assert(_clock.mutex);
+    esp_timer_create_args_t const args = {
+        .callback = &_clock_drift_cb,
+        .name = "clock_drift",
+    };
+    ESP_ERROR_CHECK(esp_timer_create(&args, &_clock.timer));
+    ESP_ERROR_CHECK(esp_timer_start_periodic(_clock.timer, CLOCK_DRIFT_PERIOD_US));
+}
+
+// Discipline the wall clock with the time stamp `server` from the response.  Only the
+// first sync, or a large offset, steps the clock.  Returns true when it did, so that the
+// caller can re-arm the alarm timer.
+static bool
+_clock_sync(time_t const server)
+{
+    if (!server || !_fetch.recv_us) {
+        return false;
     }
-    cJSON const *const jsonPushId = cJSON_GetObjectItem(jsonRoot, "pushId");
-    if (!jsonPushId || jsonPushId->type != cJSON_String) {
-        ESP_LOGW(TAG, "JSON.pushId is missing (or not an string)");
-        return;
+    xSemaphoreTake(_clock.mutex, portMAX_DELAY);
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    int64_t const now_us = esp_timer_get_time();
+    clock_discipline_sample_t const sample = {
+        .server = server,
+        .send_us = _fetch.send_us,
+        .recv_us = _fetch.recv_us,
+        .wall_us = (int64_t)tv.tv_sec * 1000000 + tv.tv_usec - (now_us - _fetch.recv_us),
+    };
+    bool step;
+    int64_t const correction_us = clock_discipline_sync(&_clock.cd, &sample, &step);
+    if (step) {
+        int64_t const wall_us = (int64_t)tv.tv_sec * 1000000 + tv.tv_usec + correction_us;
+        struct timeval const set = {
+            .tv_sec = wall_us / 1000000,
+            .tv_usec = wall_us % 1000000
+        };
+        settimeofday(&set, NULL);  // also cancels what was still being slewed
+    } else {
+        _clock_slew(correction_us);
     }
-    strncpy(pushId, jsonPushId->valuestring, pushId_len);
-    cJSON_Delete(jsonRoot);
+    xSemaphoreGive(_clock.mutex);
+    ESP_LOGI(TAG, "clock offset %lld ms, %s %lld ms, rtt %lld ms, drift %d ppb",
+             (long long)_clock.cd.offset_us / 1000, step ? "stepped" : "slewing", (long long)correction_us / 1000,
+             (long long)_clock.cd.rtt_us / 1000, (int)_clock.cd.drift_ppb);
+    return step;
 }
 
 void
@@ -106,42 +203,92 @@ https_client_task(void * ipc_void)
     char * const pushId = malloc(pushId_len);
     assert(pushId);
     *pushId = '\0';
+    char hash[24] = "";  // of the events that the display task has
+    _clock_init();
+    if (!tz_init(&_tz, getenv("TZ"))) {
+        ESP_LOGE(TAG, "can't parse TZ, using UTC");
+    }
+    // the push notification channel is renewed by each poll, so that bounds the interval
+    poll_schedule_init(&_poll, CONFIG_CALALARM_GAS_INTERVAL * 60, PUSH_SERVICE_DURATION_S);
+    https_fetch_init(&_fetch, _body_cb, NULL);
 
     while (1) {
 
-        char * url;
-        assert(asprintf(&url, "%s?devName=%s&pushId=%s", CONFIG_CALALARM_GAS_CALENDAR_URL, ipc->dev.name, pushId) >= 0);
-        ESP_LOGI(TAG, "url = \"%s\"", url);
-
-        esp_http_client_config_t config = {
-            .url = url,
-            .event_handler = _http_event_handle,
-            .buffer_size = 2048, // big enough so "Location:" in the header doesn't get split over 2 chunks
-        };
-        esp_http_client_handle_t client = esp_http_client_init(&config);
+        char url[256];
+        int const url_len = snprintf(url, sizeof(url), "%s?devName=%s&pushId=%s&hash=%s", CONFIG_CALALARM_GAS_CALENDAR_URL, ipc->dev.name, pushId, hash);
+        bool const url_ok = url_len >= 0 && (size_t)url_len < sizeof(url);
+        if (url_ok) {
+            ESP_LOGI(TAG, "url = \"%s\"", url);
+        } else {
+            ESP_LOGE(TAG, "url needs %d bytes, more than the %u it has, skipping the poll", url_len, (uint)sizeof(url));
+        }
 
-        if (esp_http_client_perform(client) == ESP_OK) {
-            int const status = esp_http_client_get_status_code(client);
-            // content_length returns -1 to indicate the data arrived chunked, instead use the data_len that we stored
-            ESP_LOGI(TAG, "status = %d, _data_len = %d", status, _data_len);
+        calendar_json_payload_t * payload = url_ok ? msg_pool_alloc(sizeof(calendar_json_payload_t)) : NULL;
+        if (url_ok && !payload) {
+            ESP_LOGE(TAG, "msg_pool has no block for the calendar");
+        }
+        if (payload) {
+            _body.payload = payload;
+            int const status = https_fetch_get(&_fetch, url);
+            _body.payload = NULL;
+            ESP_LOGI(TAG, "status = %d", status);
             if (status == 200) {
-                _data[_data_len] = '\0';
-                ESP_LOGI(TAG, "rx \"%s\"", _data);
-                sendToDisplay(TO_DISPLAY_MSGTYPE_JSON, _data, ipc);
-                _json2pushId(_data, pushId, pushId_len);
+                calendar_json_t const * const json = &payload->json;
+                if (calendar_json_status(json) != CALENDAR_JSON_DONE) {
+                    ESP_LOGE(TAG, "JSON err");
+                }
+                if (!json->pushId) {
+                    ESP_LOGW(TAG, "JSON.pushId is missing (or not an string)");
+                }
+                strlcpy(pushId, json->pushId ? json->pushId : "", pushId_len);
+                if (_clock_sync(json->time)) {
+                    alarm_timer_rearm();  // the timer counts from boot, not from the wall clock
+                }
+
+                // only a complete payload vouches for its hash; after a partial one, the
+                // next poll sends no hash, so it gets all events again
+                bool const complete = calendar_json_status(json) == CALENDAR_JSON_DONE && !json->events_dropped;
+                // the script leaves the events out when they match the hash we sent
+                bool const unchanged = complete && json->hash && strcmp(json->hash, hash) == 0;
+                ESP_LOGI(TAG, "%s, %u bytes, %u events, parsed in %lld us",
+                         unchanged ? "unchanged" : complete ? "changed" : "incomplete", _body.len, json->events_len, (long long)_body.parse_us);
+                if (complete && json->hash) {  // without it, every poll would look like an edit
+                    struct tm tm;
+                    tz_localtime(&_tz, json->time, &tm);
+                    poll_schedule_polled(&_poll, json->time, tm.tm_hour, !unchanged && hash[0]);
+                }
+                if (!unchanged) {
+                    poll_schedule_clear_alarms(&_poll);
+                    for (uint ii = 0; ii < json->events_len; ii++) {
+                        poll_schedule_add_alarm(&_poll, json->events[ii].alarm);
+                    }
+                    char new_hash[sizeof(hash)];
+                    strlcpy(new_hash, json->hash && strlen(json->hash) < sizeof(hash) ? json->hash : "", sizeof(new_hash));
+                    bool const sent = sendBlockToDisplay(TO_DISPLAY_MSGTYPE_CALENDAR, payload, ipc);
+                    if (!complete) {
+                        hash[0] = '\0';
+                    } else if (sent) {
+                        strcpy(hash, new_hash);  // only once the display task has these events
+                    }
+                    payload = NULL;  // the display task returns it
+                }
             }
         }
-        free(url);
-        esp_http_client_cleanup(client);
+        msg_pool_free(payload);
 
+        // closer to an alarm, and in the hours when the calendar is often edited, it polls
+        // more often; push notifications bring the edits, but not the alarm getting closer
         bool const pushActive = strlen(pushId);
-        uint const pushServiceDuration = 60;  // max push notification service duration is 1 hr
+        time_t const now = time(NULL);
+        struct tm tm;
+        tz_localtime(&_tz, now, &tm);
+        uint32_t const wait_s = poll_schedule_interval(&_poll, now, tm.tm_hour, pushActive);
+        ESP_LOGI(TAG, "next poll in %u s", (uint)wait_s);
 
-        uint const waitMinutes = pushActive ? pushServiceDuration : CONFIG_CALALARM_GAS_INTERVAL;
         toClientMsg_t msg;
-        if (xQueueReceive(ipc->toClientQ, &msg, waitMinutes * 60000L / portTICK_PERIOD_MS) == pdPASS) {
+        if (xQueueReceive(ipc->toClientQ, &msg, wait_s * 1000LL / portTICK_PERIOD_MS) == pdPASS) {
             // when we receive a push notification, we loop and pull the information using the Google Script
-            free(msg.data);
+            msg_pool_free(msg.data);
         }
     }
 }
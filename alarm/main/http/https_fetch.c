@@ -0,0 +1,173 @@
+/**
+ * @brief https_fetch, GET over a long-lived connection to each host, following the redirect
+ *
+ * © Copyright 2016, 2022, Sander and Coert Vonk
+ *
+ * This file is part of CALalarm.
+ *
+ * CALalarm is free software: you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * CALalarm is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with CALalarm.
+ * If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ **/
+
+#include <stdio.h>
+#include <string.h>
+#include <strings.h>
+#include <esp_log.h>
+#include <esp_timer.h>
+#include <esp_http_client.h>
+
+#include "https_fetch.h"
+
+// GAS answers with a redirect to another host, where the response can be picked up.
+// Each host gets its own long-lived handle, so its connection (and the TLS session on
+// it) is kept alive between polls, instead of two new handshakes every time.  When the
+// server closed the idle connection in the meantime, the request is retried once on a
+// new one.
+// Only depends on esp_http_client, so it can be exercised on a host against a stand-in.
+
+static char const * const TAG = "https_fetch";
+
+static esp_err_t
+_http_event_handle(esp_http_client_event_t * evt)
+{
+    https_conn_t * const conn = evt->user_data;
+    https_fetch_t * const f = conn->fetch;
+    https_phases_t * const phases = &conn->phases;
+    int64_t const now_us = esp_timer_get_time();
+
+    switch (evt->event_id) {
+        case HTTP_EVENT_ON_CONNECTED:
+            phases->connected_us = now_us;
+            conn->connects++;
+            break;
+        case HTTP_EVENT_HEADER_SENT:
+            phases->sent_us = now_us;
+            if (!f->send_us) {
+                f->send_us = now_us;
+            }
+            break;
+        case HTTP_EVENT_ON_HEADER:
+            if (!phases->header_us) {
+                phases->header_us = now_us;
+            }
+            if (f->send_us && !f->recv_us) {
+                f->recv_us = now_us;
+            }
+            if (strcasecmp(evt->header_key, "Location") == 0) {
+                snprintf(f->location, sizeof(f->location), "%s", evt->header_value);
+            }
+            break;
+        case HTTP_EVENT_ON_FINISH:
+            phases->finish_us = now_us;
+            break;
+        case HTTP_EVENT_ON_DATA:
+            // the body arrives chunked, content_length returns -1; the body of a redirect is ignored
+            if (esp_http_client_get_status_code(evt->client) == 200) {
+                f->body_cb(f->ctx, evt->data, evt->data_len);
+            }
+            break;
+        default:
+            break;
+    }
+    return ESP_OK;
+}
+
+static void
+_log_phases(https_conn_t const * const conn, int const status)
+{
+    https_phases_t const * const p = &conn->phases;
+    int64_t const begin_us = p->connected_us ? p->connected_us : p->start_us;
+    ESP_LOGI(TAG, "%s %d: connect %lld ms%s, ttfb %lld ms, body %lld ms (%u handshakes)",
+             conn->host == HTTPS_HOST_SCRIPT ? "script" : "content", status,
+             p->connected_us ? (long long)(p->connected_us - p->start_us) / 1000 : 0LL, p->connected_us ? "" : " (reused)",
+             p->header_us ? (long long)(p->header_us - begin_us) / 1000 : -1LL,
+             p->finish_us && p->header_us ? (long long)(p->finish_us - p->header_us) / 1000 : -1LL,
+             conn->connects);
+}
+
+// GET `url` on the long-lived handle for `host`
+static esp_err_t
+_fetch(https_fetch_t * const f, https_host_t const host, char const * const url, int * const status)
+{
+    https_conn_t * const conn = &f->conns[host];
+    if (!conn->handle) {
+        esp_http_client_config_t const config = {
+            .url = url,
+            .event_handler = _http_event_handle,
+            .user_data = conn,
+            .buffer_size = 2048,
+            .disable_auto_redirect = true,  // so each host keeps its own connection
+            .keep_alive_enable = true,
+        };
+        conn->handle = esp_http_client_init(&config);
+        if (!conn->handle) {
+            ESP_LOGE(TAG, "can't create a client for %s", url);
+            return ESP_FAIL;
+        }
+    } else {
+        esp_http_client_set_url(conn->handle, url);
+    }
+    esp_err_t err = ESP_FAIL;
+    for (uint attempt = 0; attempt < 2 && err != ESP_OK; attempt++) {
+        if (attempt) {
+            esp_http_client_close(conn->handle);  // the server probably closed the idle connection
+        }
+        memset(&conn->phases, 0, sizeof(https_phases_t));
+        conn->phases.start_us = esp_timer_get_time();
+        f->location[0] = '\0';
+        if (host == HTTPS_HOST_SCRIPT) {
+            f->send_us = f->recv_us = 0;  // not from an attempt that failed
+        }
+        f->body_cb(f->ctx, NULL, 0);  // start over, in case an earlier attempt got part of a body
+        err = esp_http_client_perform(conn->handle);
+    }
+    *status = esp_http_client_get_status_code(conn->handle);
+    _log_phases(conn, err == ESP_OK ? *status : -1);
+    return err;
+}
+
+static bool
+_is_redirect(int const status)
+{
+    return status == 301 || status == 302 || status == 303 || status == 307 || status == 308;
+}
+
+void
+https_fetch_init(https_fetch_t * const f, https_body_cb_t const body_cb, void * const ctx)
+{
+    memset(f, 0, sizeof(https_fetch_t));
+    for (uint ii = 0; ii < HTTPS_HOST_CNT; ii++) {
+        f->conns[ii].fetch = f;
+        f->conns[ii].host = ii;
+    }
+    f->body_cb = body_cb;
+    f->ctx = ctx;
+}
+
+// GET `url`, following the redirect manually.  Returns the HTTP status, or -1.
+int
+https_fetch_get(https_fetch_t * const f, char const * const url)
+{
+    int status;
+    if (_fetch(f, HTTPS_HOST_SCRIPT, url, &status) != ESP_OK) {
+        return -1;
+    }
+    for (uint ii = 0; ii < HTTPS_MAX_REDIRECTS && _is_redirect(status) && f->location[0]; ii++) {
+        static char location[HTTPS_LOCATION_LEN];  // `f->location` is overwritten by the next fetch
+        strcpy(location, f->location);
+        if (_fetch(f, HTTPS_HOST_CONTENT, location, &status) != ESP_OK) {
+            return -1;
+        }
+    }
+    return status;
+}
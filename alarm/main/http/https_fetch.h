@@ -0,0 +1,48 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+#include <sys/types.h>
+#include <esp_err.h>
+#include <esp_http_client.h>
+
+#define HTTPS_MAX_REDIRECTS (3)
+#define HTTPS_LOCATION_LEN (1024)
+
+typedef enum https_host_t {
+    HTTPS_HOST_SCRIPT,   // CONFIG_CALALARM_GAS_CALENDAR_URL
+    HTTPS_HOST_CONTENT,  // where it redirects to
+    HTTPS_HOST_CNT
+} https_host_t;
+
+typedef struct https_phases_t {  // monotonic [us], 0 when the event didn't happen
+    int64_t start_us;
+    int64_t connected_us;  // DNS, TCP and TLS, only when it needed a new connection
+    int64_t sent_us;       // request headers sent
+    int64_t header_us;     // first response header, so TTFB
+    int64_t finish_us;     // body received
+} https_phases_t;
+
+struct https_fetch_t;
+
+typedef struct https_conn_t {
+    struct https_fetch_t * fetch;
+    https_host_t host;
+    esp_http_client_handle_t handle;
+    https_phases_t phases;
+    uint connects;  // new connections, so TLS handshakes
+} https_conn_t;
+
+// called with each piece of a 200 body, and with NULL when a body starts (over)
+typedef void (* https_body_cb_t)(void * const ctx, char const * const data, int const len);
+
+typedef struct https_fetch_t {
+    https_conn_t conns[HTTPS_HOST_CNT];
+    char location[HTTPS_LOCATION_LEN];  // of the last redirect
+    int64_t send_us;  // the first request was sent [us], for the clock discipline
+    int64_t recv_us;  // its response headers were received [us]
+    https_body_cb_t body_cb;
+    void * ctx;
+} https_fetch_t;
+
+void https_fetch_init(https_fetch_t * const f, https_body_cb_t const body_cb, void * const ctx);
+int https_fetch_get(https_fetch_t * const f, char const * const url);
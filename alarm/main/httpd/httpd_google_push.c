@@ -52,13 +52,14 @@ _httpd_google_push_handler(httpd_req_t * req)
         return ESP_FAIL;
     }
     // +1 so even for no content body, we have a buf
-    char * const buf = malloc(req->content_len + 1);  // https_client_task reads from Q and frees mem
+    char * const buf = malloc(req->content_len + 1);  // sendToClient() copies it
     assert(buf);
 
     uint len = 0;
     while (len < req->content_len) {
         uint received = httpd_req_recv(req, buf + len, req->content_len);
         if (received <= 0) {
+            free(buf);
             httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "Failed to post value");
             return ESP_FAIL;
         }
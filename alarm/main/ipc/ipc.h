@@ -34,13 +34,13 @@ typedef struct ipc_t {
 // to display
 
 typedef enum toDisplayMsgType_t {
-    TO_DISPLAY_MSGTYPE_JSON,
+    TO_DISPLAY_MSGTYPE_CALENDAR,  // calendar_json_payload_t, parsed as it arrived
     TO_DISPLAY_MSGTYPE_STATUS
 } toDisplayMsgType_t;
 
 typedef struct toDisplayMsg_t {
     toDisplayMsgType_t dataType;
-    char * data;  // must be freed by recipient
+    void * data;  // from msg_pool, must be returned by the recipient
 } toDisplayMsg_t;
 
 // to client
@@ -51,7 +51,7 @@ typedef enum toClientMsgType_t {
 
 typedef struct toClientMsg_t {
     toClientMsgType_t dataType;
-    char * data;  // must be freed by recipient
+    char * data;  // from msg_pool, must be returned by the recipient
 } toClientMsg_t;
 
 // to buzzer
@@ -68,4 +68,5 @@ typedef struct toBuzzerMsg_t {
 
 void sendToClient(toClientMsgType_t const dataType, char const * const data, ipc_t const * const ipc);
 void sendToDisplay(toDisplayMsgType_t const dataType, char const * const data, ipc_t const * const ipc);
+bool sendBlockToDisplay(toDisplayMsgType_t const dataType, void * const block, ipc_t const * const ipc);
 void sendToBuzzer(toBuzzerMsgType_t const dataType, ipc_t const * const ipc);
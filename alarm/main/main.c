@@ -201,10 +201,10 @@ app_main()
     esp_partition_t const * const running_part = esp_ota_get_running_partition();
     esp_app_desc_t running_app_info;
     ESP_ERROR_CHECK(esp_ota_get_partition_description(running_part, &running_app_info));
-    sendToDisplay(TO_DISPLAY_MSGTYPE_STATUS, strdup(running_app_info.version), &ipc);
+    sendToDisplay(TO_DISPLAY_MSGTYPE_STATUS, running_app_info.version, &ipc);
 
     _connect2wifi_and_start_httpd(&ipc);
-    sendToDisplay(TO_DISPLAY_MSGTYPE_STATUS, strdup("gCalendar .."), &ipc);
+    sendToDisplay(TO_DISPLAY_MSGTYPE_STATUS, "gCalendar ..", &ipc);
  
     // from here the tasks take over
 
@@ -0,0 +1,163 @@
+/**
+ * @brief msg_pool, fixed blocks for the payload of the messages between tasks
+ *
+ * © Copyright 2016, 2022, Sander and Coert Vonk
+ *
+ * This file is part of CALalarm.
+ *
+ * CALalarm is free software: you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * CALalarm is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with CALalarm.
+ * If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ **/
+
+#include <string.h>
+#include <stdbool.h>
+
+#include "msg_pool.h"
+
+// The payloads used to be strdup()'d by the sender and freed by the recipient.  On a
+// device that runs for months, that churns and fragments the heap.  Instead, they are
+// copied (or built) in blocks from two fixed-size classes, that are reserved at build time.
+// When a class runs out, the message is dropped, like when its queue is full.
+// Only depends on the C library, so it can be exercised on a host.
+
+#ifdef ESP_PLATFORM
+# include <freertos/FreeRTOS.h>
+# include <esp_log.h>
+static char const * const TAG = "msg_pool";
+static portMUX_TYPE _mux = portMUX_INITIALIZER_UNLOCKED;
+# define POOL_LOCK() portENTER_CRITICAL(&_mux)
+# define POOL_UNLOCK() portEXIT_CRITICAL(&_mux)
+#else
+# define POOL_LOCK()
+# define POOL_UNLOCK()
+#endif
+
+typedef struct class_t {
+    char * blocks;
+    size_t size;
+    uint cnt;
+    uint32_t used;  // bit for each block
+    uint used_cnt, used_max;
+} class_t;
+
+// aligned like malloc(), the blocks hold structs such as calendar_json_payload_t
+static _Alignas(max_align_t) char _small[MSG_POOL_SMALL_CNT][MSG_POOL_SMALL_SIZE];
+static _Alignas(max_align_t) char _large[MSG_POOL_LARGE_CNT][MSG_POOL_LARGE_SIZE];
+
+static struct {
+    class_t small, large;
+    uint failed;
+    uint foreign;
+} _pool = {
+    .small = { .blocks = &_small[0][0], .size = MSG_POOL_SMALL_SIZE, .cnt = MSG_POOL_SMALL_CNT },
+    .large = { .blocks = &_large[0][0], .size = MSG_POOL_LARGE_SIZE, .cnt = MSG_POOL_LARGE_CNT },
+};
+
+static char *
+_alloc(class_t * const c)
+{
+    for (uint ii = 0; ii < c->cnt; ii++) {
+        if (!(c->used & (1UL << ii))) {
+            c->used |= 1UL << ii;
+            if (++c->used_cnt > c->used_max) {
+                c->used_max = c->used_cnt;
+            }
+            return c->blocks + ii * c->size;
+        }
+    }
+    return NULL;
+}
+
+// false when `block` is not one that `c` handed out, and still has out
+static bool
+_free(class_t * const c, char * const block)
+{
+    if (block < c->blocks || block >= c->blocks + c->cnt * c->size || (block - c->blocks) % c->size) {
+        return false;
+    }
+    uint const ii = (block - c->blocks) / c->size;
+    if (!(c->used & (1UL << ii))) {
+        return false;  // freed twice
+    }
+    c->used &= ~(1UL << ii);
+    c->used_cnt--;
+    return true;
+}
+
+// a block from the smallest class that `size` fits in; NULL when it doesn't fit, or
+// when that class is used up
+void *
+msg_pool_alloc(size_t const size)
+{
+    POOL_LOCK();
+    char * block = NULL;
+    if (size <= MSG_POOL_SMALL_SIZE) {
+        block = _alloc(&_pool.small);
+    }
+    if (!block && size <= MSG_POOL_LARGE_SIZE) {
+        block = _alloc(&_pool.large);
+    }
+    if (!block) {
+        _pool.failed++;
+    }
+    POOL_UNLOCK();
+    return block;
+}
+
+// like strdup(), but from msg_pool_alloc()
+char *
+msg_pool_strdup(char const * const str)
+{
+    size_t const size = strlen(str) + 1;
+    char * const block = msg_pool_alloc(size);
+    if (block) {
+        memcpy(block, str, size);
+    }
+    return block;
+}
+
+// return a block from msg_pool_alloc() or msg_pool_strdup(), NULL is ignored; anything
+// else, or a block that was already returned, is counted and left alone
+void
+msg_pool_free(void * const block)
+{
+    if (!block) {
+        return;
+    }
+    POOL_LOCK();
+    bool const ok = _free(&_pool.small, block) || _free(&_pool.large, block);
+    if (!ok) {
+        _pool.foreign++;
+    }
+    POOL_UNLOCK();
+#ifdef ESP_PLATFORM
+    if (!ok) {
+        ESP_LOGE(TAG, "%p is not a block in use", block);
+    }
+#endif
+}
+
+void
+msg_pool_get_stats(msg_pool_stats_t * const stats)
+{
+    POOL_LOCK();
+    *stats = (msg_pool_stats_t) {
+        .small_used = _pool.small.used_cnt,
+        .small_max = _pool.small.used_max,
+        .large_used = _pool.large.used_cnt,
+        .large_max = _pool.large.used_max,
+        .failed = _pool.failed,
+        .foreign = _pool.foreign,
+    };
+    POOL_UNLOCK();
+}
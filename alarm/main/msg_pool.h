@@ -0,0 +1,21 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include <sys/types.h>
+
+#define MSG_POOL_SMALL_SIZE (64)        // status lines and push notifications
+#define MSG_POOL_SMALL_CNT (8)
+#define MSG_POOL_LARGE_SIZE (3584)      // a parsed calendar, or a push notification and its NUL
+#define MSG_POOL_LARGE_CNT (3)          // two in the queues, one being filled or processed
+
+typedef struct msg_pool_stats_t {
+    uint small_used, small_max;  // blocks in use, and the most ever in use
+    uint large_used, large_max;
+    uint failed;                 // requests that didn't fit, or found the pool empty
+    uint foreign;                // msg_pool_free() of something that isn't a block in use
+} msg_pool_stats_t;
+
+void * msg_pool_alloc(size_t const size);
+char * msg_pool_strdup(char const * const str);
+void msg_pool_free(void * const block);
+void msg_pool_get_stats(msg_pool_stats_t * const stats);
@@ -0,0 +1,162 @@
+/**
+ * @brief oled_flush_task, owns the I2C bus to the OLED and sends the frames that display_task composes
+ *
+ * © Copyright 2016, 2022, Sander and Coert Vonk
+ * 
+ * This file is part of CALalarm.
+ * 
+ * CALalarm is free software: you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ * 
+ * CALalarm is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License along with CALalarm. 
+ * If not, see <https://www.gnu.org/licenses/>.
+ * 
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ **/
+
+#include <string.h>
+#include <esp_log.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <freertos/semphr.h>
+
+#include "oled_flush_task.h"
+#include "ssd1306.h"
+
+static char const * const TAG = "oled_flush_task";
+
+// display_task composes in its own SSD1306_t (the back buffer) and copies the result
+// to `front`.  This task picks up the latest front buffer and sends it to the panel.
+// Frames that arrive while the bus is still busy replace the pending one.
+//
+// A frame may mark one page as marquee.  That page is handed to the controller's
+// horizontal scroll, so the text moves without CPU or bus traffic.  ssd1306_show_dirty()
+// leaves the scrolled page alone, so repainting the clock on the other pages neither
+// stops nor disturbs it.  The scroll is only restarted when the marquee content changes.
+// The datasheet leaves RAM writes during scrolling undefined, but writes to pages outside
+// the scroll range work fine on the panels we use.
+
+#define MARQUEE_INTERVAL (0x00)  // frame interval code, 0x00 is 5 frames per column
+
+static struct {
+    SemaphoreHandle_t mutex;  // protects the fields below
+    TaskHandle_t task;
+    uint8_t front[8][128];
+    bool frame_pending;
+    int marquee_page;         // -1 for none
+    int contrast;
+    bool contrast_pending;
+    uint coalesced;           // frames replaced before they were sent
+} _flush;
+
+static SSD1306_t _panel;  // owned by oled_flush_task
+
+static struct {
+    bool active;
+    int page;
+    uint8_t strip[128];       // what the controller is scrolling
+} _marquee;                   // owned by oled_flush_task
+
+static void
+_marquee_update(int const page)
+{
+    // stop a scroll whose text changed, that also marks its page for a full rewrite
+    if (_marquee.active &&
+        (page != _marquee.page || memcmp(_marquee.strip, _panel._page[page]._segs, _panel._width) != 0)) {
+
+        ssd1306_hardware_scroll_pages(&_panel, SCROLL_STOP, _marquee.page, _marquee.page, MARQUEE_INTERVAL);
+        _marquee.active = false;
+    }
+
+    // repaint what changed, skipping the page that is still scrolling
+    ssd1306_show_dirty(&_panel);
+
+    // hand the (new) text to the controller, it keeps moving it on its own
+    if (page >= 0 && !_marquee.active) {
+        memcpy(_marquee.strip, _panel._page[page]._segs, _panel._width);
+        _marquee.page = page;
+        _marquee.active = true;
+        ssd1306_hardware_scroll_pages(&_panel, SCROLL_LEFT, page, page, MARQUEE_INTERVAL);
+    }
+}
+
+static void
+_oled_flush_task(void * unused)
+{
+    while (1) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+        xSemaphoreTake(_flush.mutex, portMAX_DELAY);
+        bool const frame_pending = _flush.frame_pending;
+        int const marquee_page = _flush.marquee_page;
+        if (frame_pending) {
+            for (int page = 0; page < _panel._pages; page++) {
+                memcpy(_panel._page[page]._segs, _flush.front[page], sizeof(_flush.front[page]));
+            }
+        }
+        bool const contrast_pending = _flush.contrast_pending;
+        int const contrast = _flush.contrast;
+        uint const coalesced = _flush.coalesced;
+        _flush.frame_pending = false;
+        _flush.contrast_pending = false;
+        _flush.coalesced = 0;
+        xSemaphoreGive(_flush.mutex);
+
+        if (contrast_pending) {
+            ssd1306_contrast(&_panel, contrast);
+        }
+        if (frame_pending) {
+            _marquee_update(marquee_page);
+        }
+
+        ssd1306_stats_t stats;
+        ssd1306_get_stats(&_panel, &stats, true);
+        ESP_LOGD(TAG, "flush sent %u bytes in %u transactions (%u us on the wire), skipped %u unchanged bytes, coalesced %u frames",
+                 stats.bytes, stats.transactions, stats.wire_us, stats.skipped, coalesced);
+    }
+}
+
+// `dev` must be initialized.  From here on, only oled_flush_task talks to the panel.
+void
+oled_flush_start(SSD1306_t const * const dev)
+{
+    _panel = *dev;
+    _flush.marquee_page = -1;
+    _flush.mutex = xSemaphoreCreateMutex();
+    assert(_flush.mutex);
+    xTaskCreate(&_oled_flush_task, "oled_flush_task", 4096, NULL, 5, &_flush.task);
+    assert(_flush.task);
+}
+
+// hand over the frame composed in `dev`, returns without waiting for the bus
+// `marquee_page` is the page that scrolls in a loop, or -1 for none
+void
+oled_flush_swap(SSD1306_t const * const dev, int const marquee_page)
+{
+    xSemaphoreTake(_flush.mutex, portMAX_DELAY);
+    for (int page = 0; page < dev->_pages; page++) {
+        memcpy(_flush.front[page], dev->_page[page]._segs, sizeof(_flush.front[page]));
+    }
+    if (_flush.frame_pending) {
+        _flush.coalesced++;
+    }
+    _flush.frame_pending = true;
+    _flush.marquee_page = (marquee_page >= 0 && marquee_page < dev->_pages) ? marquee_page : -1;
+    xSemaphoreGive(_flush.mutex);
+    xTaskNotifyGive(_flush.task);
+}
+
+void
+oled_flush_contrast(int const contrast)
+{
+    xSemaphoreTake(_flush.mutex, portMAX_DELAY);
+    _flush.contrast = contrast;
+    _flush.contrast_pending = true;
+    xSemaphoreGive(_flush.mutex);
+    xTaskNotifyGive(_flush.task);
+}
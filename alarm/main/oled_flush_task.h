@@ -0,0 +1,6 @@
+#pragma once
+#include "ssd1306.h"
+
+void oled_flush_start(SSD1306_t const * const dev);
+void oled_flush_swap(SSD1306_t const * const dev, int const marquee_page);
+void oled_flush_contrast(int const contrast);
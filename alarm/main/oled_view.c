@@ -0,0 +1,119 @@
+/**
+ * @brief oled_view, composes what the OLED shows into a frame
+ *
+ * © Copyright 2016, 2022, Sander and Coert Vonk
+ *
+ * This file is part of CALalarm.
+ *
+ * CALalarm is free software: you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * CALalarm is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with CALalarm.
+ * If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ **/
+
+#include <stdio.h>
+#include <string.h>
+
+#include "oled_view.h"
+
+// The display task keeps an oled_view_t with what should be on the display.  The
+// view is rendered as a whole into the frame buffer, and then handed to
+// oled_flush_task in one go, so the panel never shows a partial update.
+// Only depends on the ssd1306 frame buffer, so it can be exercised on a host.
+//
+//   page 0..2: clock in 3x high digits, AM/PM to the right of it
+//   page 3:    status, followed by the link symbol when push notifications are active
+//
+// A status that is too wide becomes a marquee, that the controller scrolls across the
+// whole page.  One that is too wide for that, is cut short with an ellipsis.
+
+void
+oled_view_set_time(oled_view_t * const view, struct tm const * const tm)
+{
+    // jump through hoops for 12-hour time
+    view->clock = true;
+    view->hrs = (tm->tm_hour % 12 == 0) ? 12 : tm->tm_hour % 12;
+    view->min = tm->tm_min;
+    view->pm = tm->tm_hour >= 12;
+}
+
+void
+oled_view_set_status(oled_view_t * const view, char const * const status, bool const link)
+{
+    snprintf(view->status, sizeof(view->status), "%s", status);
+    view->link = link;
+}
+
+static void
+_render_clock(SSD1306_t * const dev, oled_view_t const * const view)
+{
+    char str[6] = "     ";  // blank until the time is known
+    if (view->clock) {
+        snprintf(str, sizeof(str), "%2d:%02d", view->hrs % 100, view->min % 100);  // work around `-Wformat-truncation`
+    }
+    ssd1306_compose_text_x3(dev, 0, 0, str, strlen(str), false);
+
+    // right of the 3x high clock digits
+    ssd1306_compose_text(dev, 0, 120, view->clock ? (view->pm ? "P" : "A") : " ", 1, false);
+    ssd1306_compose_text(dev, 1, 120, view->clock ? "M" : " ", 1, false);
+    ssd1306_compose_text(dev, 2, 120, " ", 1, false);
+}
+
+// Copies `text` to `out`, cut short with an ellipsis when wider than `width` columns
+static void
+_ellipsize(char const * const text, int const width, char * const out, size_t const out_size)
+{
+    snprintf(out, out_size, "%s", text);
+    if (ssd1306_text_width_prop(out) <= width) {
+        return;
+    }
+    char const ellipsis[] = "...";
+    int const room = width - ssd1306_text_width_prop(ellipsis);
+    size_t len = strlen(out);
+    while (len && (out[len - 1] == ' ' || ssd1306_text_width_prop(out) > room)) {
+        out[--len] = '\0';
+    }
+    snprintf(out + len, out_size - len, "%s", ellipsis);
+}
+
+// returns true when the text doesn't fit, and page 3 should scroll as a marquee
+static bool
+_render_status(SSD1306_t * const dev, oled_view_t const * const view)
+{
+    // proportional font, so longer titles fit; the link symbol takes the last two 8x8 cells
+    int const link_seg = 128 - 2 * 8;
+    int const gap = 4;
+    int const text_width = view->link ? link_seg - gap : 128;
+
+    if (ssd1306_text_width_prop(view->status) > text_width) {
+        // the controller rotates the whole 128 column page, so give the text all of it
+        // except for a gap where it wraps around; the link symbol makes room for it
+        int const loop_gap = 8;
+        char text[sizeof(view->status) + 3];
+        _ellipsize(view->status, 128 - loop_gap, text, sizeof(text));
+        ssd1306_compose_text_prop(dev, 3, 0, text, 128, false);  // also clears the loop gap
+        return true;
+    }
+    ssd1306_compose_text_prop(dev, 3, 0, view->status, text_width, false);
+    if (view->link) {
+        ssd1306_compose_text_prop(dev, 3, link_seg - gap, "", gap, false);  // clear the gap
+        ssd1306_compose_text(dev, 3, link_seg, "\x03\x04", 2, false);
+    }
+    return false;
+}
+
+// Compose the whole frame.  Returns the page that should scroll as a marquee, or -1.
+int
+oled_view_render(SSD1306_t * const dev, oled_view_t const * const view)
+{
+    _render_clock(dev, view);
+    return _render_status(dev, view) ? 3 : -1;
+}
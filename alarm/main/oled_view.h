@@ -0,0 +1,19 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+#include <time.h>
+#include "ssd1306.h"
+
+#define OLED_VIEW_STATUS_LEN (64)
+
+typedef struct oled_view_t {
+    bool clock;                         // false until the time is known
+    uint8_t hrs, min;                   // 12-hour clock
+    bool pm;
+    char status[OLED_VIEW_STATUS_LEN];  // a marquee when it is too wide, cut short when too wide for that
+    bool link;                          // push notifications are active
+} oled_view_t;
+
+void oled_view_set_time(oled_view_t * const view, struct tm const * const tm);
+void oled_view_set_status(oled_view_t * const view, char const * const status, bool const link);
+int oled_view_render(SSD1306_t * const dev, oled_view_t const * const view);
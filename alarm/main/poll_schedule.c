@@ -0,0 +1,119 @@
+/**
+ * @brief poll_schedule, decides when to poll the calendar next
+ *
+ * © Copyright 2016, 2022, Sander and Coert Vonk
+ *
+ * This file is part of CALalarm.
+ *
+ * CALalarm is free software: you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * CALalarm is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with CALalarm.
+ * If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ **/
+
+#include <string.h>
+
+#include "poll_schedule.h"
+
+// Each hour of the day keeps a decayed count of the polls that found the calendar
+// changed, and of the time those polls covered.  Their ratio is the edit rate for that
+// hour, and the interval is chosen so that POLL_SCHEDULE_POLLS_PER_EDIT polls go to
+// each expected edit.  Quiet hours, such as the night, and a calendar that hasn't
+// changed in a while, decay towards `max_s`.  The buckets start out at a rate that
+// gives `base_s`.
+//
+// Independent of that, the interval is at most half the time until the next alarm, so
+// the polls close in on it, and a last-minute edit is picked up before it goes off.
+// With push notifications, edits arrive by themselves, and only the alarms shorten
+// the interval.
+// Only depends on the C library, so it can be exercised on a host.
+
+void
+poll_schedule_init(poll_schedule_t * const ps, uint32_t const base_s, uint32_t const max_s)
+{
+    memset(ps, 0, sizeof(poll_schedule_t));
+    ps->base_s = base_s;
+    ps->max_s = max_s;
+    for (uint ii = 0; ii < POLL_SCHEDULE_HOURS; ii++) {
+        ps->hours[ii] = (poll_schedule_hour_t) {
+            .observed_s = POLL_SCHEDULE_MEMORY_S,
+            .changes_q16 = ((uint64_t)POLL_SCHEDULE_MEMORY_S << 16) / (POLL_SCHEDULE_POLLS_PER_EDIT * base_s),
+        };
+    }
+}
+
+void
+poll_schedule_clear_alarms(poll_schedule_t * const ps)
+{
+    ps->alarms_len = 0;
+}
+
+void
+poll_schedule_add_alarm(poll_schedule_t * const ps, time_t const alarm)
+{
+    if (ps->alarms_len < POLL_SCHEDULE_ALARMS) {
+        ps->alarms[ps->alarms_len++] = alarm;
+    }
+}
+
+// after each poll that got a response; `changed` is false when there was nothing
+// to compare with
+void
+poll_schedule_polled(poll_schedule_t * const ps, time_t const now, uint const hour, bool const changed)
+{
+    if (ps->last_poll && now > ps->last_poll) {
+        uint32_t const dt = (now - ps->last_poll < 3600) ? now - ps->last_poll : 3600;  // long gaps are outages
+        poll_schedule_hour_t * const h = &ps->hours[hour % POLL_SCHEDULE_HOURS];
+        h->observed_s -= (uint64_t)h->observed_s * dt / POLL_SCHEDULE_MEMORY_S;
+        h->changes_q16 -= (uint64_t)h->changes_q16 * dt / POLL_SCHEDULE_MEMORY_S;
+        h->observed_s += dt;
+        h->changes_q16 += changed ? 1 << 16 : 0;
+    }
+    ps->last_poll = now;
+}
+
+static uint32_t
+_rate_interval(poll_schedule_hour_t const * const h)
+{
+    if (!h->changes_q16) {
+        return UINT32_MAX;
+    }
+    uint64_t const interval = ((uint64_t)h->observed_s << 16) / ((uint64_t)POLL_SCHEDULE_POLLS_PER_EDIT * h->changes_q16);
+    return interval < UINT32_MAX ? interval : UINT32_MAX;
+}
+
+// seconds until the next poll
+uint32_t
+poll_schedule_interval(poll_schedule_t const * const ps, time_t const now, uint const hour, bool const push)
+{
+    uint32_t interval = ps->max_s;
+
+    if (!push) {
+        // the busier of this hour and the next, so it speeds up ahead of a busy hour
+        for (uint ii = 0; ii < 2; ii++) {
+            uint32_t const rate_interval = _rate_interval(&ps->hours[(hour + ii) % POLL_SCHEDULE_HOURS]);
+            if (rate_interval < interval) {
+                interval = rate_interval;
+            }
+        }
+    }
+
+    time_t next_alarm = 0;
+    for (uint ii = 0; ii < ps->alarms_len; ii++) {
+        if (ps->alarms[ii] > now && (!next_alarm || ps->alarms[ii] < next_alarm)) {
+            next_alarm = ps->alarms[ii];
+        }
+    }
+    if (next_alarm && (uint64_t)(next_alarm - now) / 2 < interval) {
+        interval = (next_alarm - now) / 2;
+    }
+    return interval > POLL_SCHEDULE_MIN_S ? interval : POLL_SCHEDULE_MIN_S;
+}
@@ -0,0 +1,31 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+#include <time.h>
+#include <sys/types.h>
+
+#define POLL_SCHEDULE_HOURS (24)              // edit rate buckets, by local hour of the day
+#define POLL_SCHEDULE_MEMORY_S (7 * 3600)     // observed time a bucket remembers, so about a week of that hour
+#define POLL_SCHEDULE_POLLS_PER_EDIT (10)     // polls to spend for each expected edit
+#define POLL_SCHEDULE_MIN_S (2 * 60)          // shortest interval, also how close to an alarm it polls
+#define POLL_SCHEDULE_ALARMS (32)             // as many as the schedule holds
+
+typedef struct poll_schedule_hour_t {
+    uint32_t observed_s;   // decayed time that polls covered in this hour [s]
+    uint32_t changes_q16;  // decayed count of changed payloads in it [1/65536]
+} poll_schedule_hour_t;
+
+typedef struct poll_schedule_t {
+    uint32_t base_s;  // interval before anything is learned
+    uint32_t max_s;   // longest interval, when the calendar is quiet
+    poll_schedule_hour_t hours[POLL_SCHEDULE_HOURS];
+    time_t last_poll;  // 0 before the first
+    time_t alarms[POLL_SCHEDULE_ALARMS];
+    uint alarms_len;
+} poll_schedule_t;
+
+void poll_schedule_init(poll_schedule_t * const ps, uint32_t const base_s, uint32_t const max_s);
+void poll_schedule_clear_alarms(poll_schedule_t * const ps);
+void poll_schedule_add_alarm(poll_schedule_t * const ps, time_t const alarm);
+void poll_schedule_polled(poll_schedule_t * const ps, time_t const now, uint const hour, bool const changed);
+uint32_t poll_schedule_interval(poll_schedule_t const * const ps, time_t const now, uint const hour, bool const push);
@@ -0,0 +1,299 @@
+/**
+ * @brief schedule, the calendar events in the next 48 hours and the alarms they set
+ *
+ * © Copyright 2016, 2022, Sander and Coert Vonk
+ *
+ * This file is part of CALalarm.
+ *
+ * CALalarm is free software: you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * CALalarm is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with CALalarm.
+ * If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ **/
+
+#include <string.h>
+
+#include "schedule.h"
+
+// Events live in fixed-size slots.  `order` lists the slots by start time, and `heap`
+// is a min-heap of the slots whose alarm is still to come.  Each payload carries the
+// whole window.  It is applied between schedule_begin() and schedule_end(), so events
+// that didn't change keep their slot and heap position, and only the events that were
+// added, moved or removed cost a heap operation.  Titles are interned in a pool, that
+// is compacted when it runs full.
+// Only depends on the C library, so it can be exercised on a host.
+
+static bool
+_before(schedule_t const * const s, uint8_t const a, uint8_t const b)
+{
+    return s->events[s->heap[a]].alarm < s->events[s->heap[b]].alarm;
+}
+
+static void
+_heap_swap(schedule_t * const s, uint8_t const a, uint8_t const b)
+{
+    uint8_t const slot = s->heap[a];
+    s->heap[a] = s->heap[b];
+    s->heap[b] = slot;
+    s->events[s->heap[a]].heap_pos = a;
+    s->events[s->heap[b]].heap_pos = b;
+}
+
+static void
+_heap_up(schedule_t * const s, uint8_t pos)
+{
+    while (pos > 0) {
+        uint8_t const parent = (pos - 1) / 2;
+        if (!_before(s, pos, parent)) {
+            break;
+        }
+        _heap_swap(s, pos, parent);
+        pos = parent;
+    }
+}
+
+static void
+_heap_down(schedule_t * const s, uint8_t pos)
+{
+    while (1) {
+        uint const left = 2 * pos + 1;
+        uint const right = left + 1;
+        uint8_t first = pos;
+        if (left < s->heap_len && _before(s, left, first)) {
+            first = left;
+        }
+        if (right < s->heap_len && _before(s, right, first)) {
+            first = right;
+        }
+        if (first == pos) {
+            break;
+        }
+        _heap_swap(s, pos, first);
+        pos = first;
+    }
+}
+
+static void
+_heap_push(schedule_t * const s, uint8_t const slot)
+{
+    uint8_t const pos = s->heap_len++;
+    s->heap[pos] = slot;
+    s->events[slot].heap_pos = pos;
+    _heap_up(s, pos);
+}
+
+static void
+_heap_remove(schedule_t * const s, uint8_t const slot)
+{
+    uint8_t const pos = s->events[slot].heap_pos;
+    if (pos == SCHEDULE_NONE) {
+        return;
+    }
+    s->events[slot].heap_pos = SCHEDULE_NONE;
+    uint8_t const last = --s->heap_len;
+    if (pos != last) {
+        s->heap[pos] = s->heap[last];
+        s->events[s->heap[pos]].heap_pos = pos;
+        _heap_up(s, pos);
+        _heap_down(s, s->events[s->heap[pos]].heap_pos);
+    }
+}
+
+// rewrite the pool with only the titles that are still in use
+static void
+_titles_compact(schedule_t * const s)
+{
+    char pool[SCHEDULE_TITLE_POOL];
+    uint16_t len = 0;
+    for (uint ii = 0; ii < SCHEDULE_MAX_EVENTS; ii++) {
+        schedule_event_t * const event = &s->events[ii];
+        if (!event->used) {
+            continue;
+        }
+        char const * const title = s->titles + event->title;
+        uint16_t offset = 0;
+        while (offset < len && strcmp(pool + offset, title) != 0) {
+            offset += strlen(pool + offset) + 1;
+        }
+        if (offset == len) {
+            size_t const size = strlen(title) + 1;
+            memcpy(pool + len, title, size);
+            len += size;
+        }
+        event->title = offset;
+    }
+    memcpy(s->titles, pool, len);
+    s->titles_len = len;
+}
+
+static bool
+_title_intern(schedule_t * const s, char const * const title, uint16_t * const offset)
+{
+    for (uint16_t ii = 0; ii < s->titles_len; ii += strlen(s->titles + ii) + 1) {
+        if (strcmp(s->titles + ii, title) == 0) {
+            *offset = ii;
+            return true;
+        }
+    }
+    size_t const size = strlen(title) + 1;
+    if (s->titles_len + size > SCHEDULE_TITLE_POOL) {
+        _titles_compact(s);
+        if (s->titles_len + size > SCHEDULE_TITLE_POOL) {
+            return false;
+        }
+    }
+    *offset = s->titles_len;
+    memcpy(s->titles + s->titles_len, title, size);
+    s->titles_len += size;
+    return true;
+}
+
+static void
+_remove(schedule_t * const s, uint const idx)
+{
+    uint8_t const slot = s->order[idx];
+    _heap_remove(s, slot);
+    s->events[slot].used = false;
+    memmove(&s->order[idx], &s->order[idx + 1], s->len - idx - 1);
+    s->len--;
+}
+
+void
+schedule_init(schedule_t * const s)
+{
+    memset(s, 0, sizeof(schedule_t));
+}
+
+// a new payload follows, events that are not in it will be removed by schedule_end()
+void
+schedule_begin(schedule_t * const s)
+{
+    for (uint ii = 0; ii < s->len; ii++) {
+        s->events[s->order[ii]].seen = false;
+    }
+}
+
+// Add an event from the payload, unless we already have it.  Only alarms after
+// `now` go in the heap, so an alarm doesn't go off again when the window is resent.
+bool
+schedule_add(schedule_t * const s, char const * const title, time_t const alarm, time_t const start, time_t const stop, time_t const now)
+{
+    uint pos = 0;  // where it goes in `order`
+    for (; pos < s->len; pos++) {
+        schedule_event_t * const event = &s->events[s->order[pos]];
+        if (event->start > start) {
+            break;
+        }
+        if (!event->seen && event->start == start && event->alarm == alarm && event->stop == stop &&
+            strcmp(s->titles + event->title, title) == 0) {
+
+            event->seen = true;
+            return true;
+        }
+    }
+    if (s->len == SCHEDULE_MAX_EVENTS) {
+        // make room by dropping an event that isn't in this payload (yet), if it shows
+        // up later, it is added again
+        uint stale = 0;
+        while (stale < s->len && s->events[s->order[stale]].seen) {
+            stale++;
+        }
+        if (stale == s->len) {
+            return false;
+        }
+        _remove(s, stale);
+        if (stale < pos) {
+            pos--;
+        }
+    }
+    uint8_t slot = 0;
+    while (s->events[slot].used) {
+        slot++;
+    }
+    schedule_event_t * const event = &s->events[slot];
+    if (!_title_intern(s, title, &event->title)) {
+        return false;
+    }
+    event->alarm = alarm;
+    event->start = start;
+    event->stop = stop;
+    event->used = true;
+    event->seen = true;
+    event->heap_pos = SCHEDULE_NONE;
+
+    memmove(&s->order[pos + 1], &s->order[pos], s->len - pos);
+    s->order[pos] = slot;
+    s->len++;
+
+    if (alarm > now) {
+        _heap_push(s, slot);
+    }
+    return true;
+}
+
+// drop the events that were moved or removed, unless the payload was incomplete
+void
+schedule_end(schedule_t * const s, bool const complete)
+{
+    uint ii = 0;
+    while (ii < s->len) {
+        if (complete && !s->events[s->order[ii]].seen) {
+            _remove(s, ii);
+        } else {
+            s->events[s->order[ii++]].seen = true;
+        }
+    }
+}
+
+// event with the earliest alarm that didn't go off yet, or NULL
+schedule_event_t const *
+schedule_next_alarm(schedule_t const * const s)
+{
+    return s->heap_len ? &s->events[s->heap[0]] : NULL;
+}
+
+// the alarm went off, or passed
+void
+schedule_pop_alarm(schedule_t * const s)
+{
+    if (s->heap_len) {
+        _heap_remove(s, s->heap[0]);
+    }
+}
+
+// Milliseconds until the display has to wake up: at the next minute boundary, or at the
+// alarm when that comes first.  Always in the future, also when `now_ms` is on a boundary.
+int64_t
+schedule_ms_until_deadline(schedule_t const * const s, int64_t const now_ms)
+{
+    int64_t deadline_ms = (now_ms / 60000 + 1) * 60000;
+    schedule_event_t const * const next = schedule_next_alarm(s);
+    if (next) {
+        int64_t const alarm_ms = (int64_t)next->alarm * 1000;
+        if (alarm_ms > now_ms && alarm_ms < deadline_ms) {
+            deadline_ms = alarm_ms;
+        }
+    }
+    return deadline_ms - now_ms;
+}
+
+char const *
+schedule_title(schedule_t const * const s, schedule_event_t const * const event)
+{
+    return s->titles + event->title;
+}
+
+// events by start time, NULL past the end
+schedule_event_t const *
+schedule_at(schedule_t const * const s, uint const idx)
+{
+    return idx < s->len ? &s->events[s->order[idx]] : NULL;
+}
@@ -0,0 +1,36 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+#include <time.h>
+#include <sys/types.h>
+
+#define SCHEDULE_MAX_EVENTS (32)    // events in the 48-hour window
+#define SCHEDULE_TITLE_POOL (1024)  // bytes for the interned titles
+#define SCHEDULE_NONE (0xFF)
+
+typedef struct schedule_event_t {
+    time_t alarm, start, stop;
+    uint16_t title;    // offset of the interned title in `schedule_t.titles`
+    uint8_t heap_pos;  // position in the alarm heap, or SCHEDULE_NONE when it went off or passed
+    bool used;
+    bool seen;         // in the payload that is being applied
+} schedule_event_t;
+
+typedef struct schedule_t {
+    schedule_event_t events[SCHEDULE_MAX_EVENTS];  // slots don't move, so indices stay valid
+    uint8_t order[SCHEDULE_MAX_EVENTS];            // slots sorted by start time
+    uint8_t heap[SCHEDULE_MAX_EVENTS];             // slots in a min-heap keyed by alarm time
+    uint8_t len, heap_len;
+    uint16_t titles_len;
+    char titles[SCHEDULE_TITLE_POOL];              // NUL-terminated, each distinct title once
+} schedule_t;
+
+void schedule_init(schedule_t * const s);
+void schedule_begin(schedule_t * const s);
+bool schedule_add(schedule_t * const s, char const * const title, time_t const alarm, time_t const start, time_t const stop, time_t const now);
+void schedule_end(schedule_t * const s, bool const complete);
+schedule_event_t const * schedule_next_alarm(schedule_t const * const s);
+void schedule_pop_alarm(schedule_t * const s);
+int64_t schedule_ms_until_deadline(schedule_t const * const s, int64_t const now_ms);
+char const * schedule_title(schedule_t const * const s, schedule_event_t const * const event);
+schedule_event_t const * schedule_at(schedule_t const * const s, uint const idx);
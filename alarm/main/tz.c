@@ -0,0 +1,361 @@
+/**
+ * @brief tz, local time from a compiled POSIX TZ rule
+ *
+ * © Copyright 2016, 2022, Sander and Coert Vonk
+ *
+ * This file is part of CALalarm.
+ *
+ * CALalarm is free software: you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * CALalarm is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with CALalarm.
+ * If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ **/
+
+#include <string.h>
+
+#include "tz.h"
+
+// newlib's localtime_r() evaluates the TZ rules on every call.  Instead, the rule is
+// parsed once, and turned into a table with the DST transitions of this year and the
+// next.  Converting a time is then a table lookup and some integer arithmetic, and a
+// tz_clock_t keeps a broken-down time that is only carried forward, until the next
+// DST edge.  The table is recompiled when a time falls outside of it.
+// Only depends on the C library, so it can be exercised on a host.
+
+static int32_t const _default_time = 2 * 3600;  // when no time is given in a rule
+
+static bool
+_is_leap(int const y)
+{
+    return (y % 4 == 0 && y % 100 != 0) || y % 400 == 0;
+}
+
+static uint
+_month_len(int const y, uint const m)
+{
+    static uint8_t const len[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+    return len[m - 1] + (m == 2 && _is_leap(y));
+}
+
+// days since 1970-01-01 in the proleptic Gregorian calendar
+int32_t
+tz_days_from_civil(int32_t y, uint const m, uint const d)
+{
+    y -= m <= 2;
+    int32_t const era = (y >= 0 ? y : y - 399) / 400;
+    uint const yoe = y - era * 400;
+    uint const doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+    uint const doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + (int32_t)doe - 719468;
+}
+
+static void
+_civil_from_days(int32_t z, int * const y, uint * const m, uint * const d)
+{
+    z += 719468;
+    int32_t const era = (z >= 0 ? z : z - 146096) / 146097;
+    uint const doe = z - era * 146097;
+    uint const yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    uint const doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    uint const mp = (5 * doy + 2) / 153;
+    *d = doy - (153 * mp + 2) / 5 + 1;
+    *m = mp < 10 ? mp + 3 : mp - 9;
+    *y = (int32_t)yoe + era * 400 + (*m <= 2);
+}
+
+static int32_t
+_floor_div(time_t const a, int32_t const b)
+{
+    return a >= 0 ? a / b : -((-a + b - 1) / b);
+}
+
+static void
+_breakdown(time_t const local, bool const isdst, struct tm * const tm)
+{
+    int32_t const days = _floor_div(local, 86400);
+    int32_t const secs = local - (time_t)days * 86400;
+    int y;
+    uint m, d;
+    _civil_from_days(days, &y, &m, &d);
+    memset(tm, 0, sizeof(struct tm));
+    tm->tm_year = y - 1900;
+    tm->tm_mon = m - 1;
+    tm->tm_mday = d;
+    tm->tm_hour = secs / 3600;
+    tm->tm_min = secs / 60 % 60;
+    tm->tm_sec = secs % 60;
+    tm->tm_wday = ((days + 4) % 7 + 7) % 7;  // 1970-01-01 was a Thursday
+    tm->tm_yday = days - tz_days_from_civil(y, 1, 1);
+    tm->tm_isdst = isdst;
+}
+
+// parsing of the POSIX TZ string, e.g. "PST8PDT,M3.2.0,M11.1.0"
+
+static char const *
+_parse_name(char const * s)
+{
+    if (*s == '<') {
+        char const * const end = strchr(s, '>');
+        return end ? end + 1 : NULL;
+    }
+    char const * const start = s;
+    while ((*s >= 'a' && *s <= 'z') || (*s >= 'A' && *s <= 'Z')) {
+        s++;
+    }
+    return s - start >= 3 ? s : NULL;
+}
+
+static char const *
+_parse_num(char const * s, uint const max, uint * const value)
+{
+    if (*s < '0' || *s > '9') {
+        return NULL;
+    }
+    *value = 0;
+    while (*s >= '0' && *s <= '9') {
+        *value = *value * 10 + (*s++ - '0');
+        if (*value > max) {
+            return NULL;
+        }
+    }
+    return s;
+}
+
+// [+|-]hh[:mm[:ss]]
+static char const *
+_parse_time(char const * s, int32_t * const secs)
+{
+    int32_t const sign = (*s == '-') ? -1 : 1;
+    if (*s == '-' || *s == '+') {
+        s++;
+    }
+    uint hh, mm = 0, ss = 0;
+    if (!(s = _parse_num(s, 167, &hh))) {
+        return NULL;
+    }
+    if (*s == ':' && !(s = _parse_num(s + 1, 59, &mm))) {
+        return NULL;
+    }
+    if (*s == ':' && !(s = _parse_num(s + 1, 59, &ss))) {
+        return NULL;
+    }
+    *secs = sign * (int32_t)(hh * 3600 + mm * 60 + ss);
+    return s;
+}
+
+// Jn, n or Mm.w.d, optionally followed by /time
+static char const *
+_parse_rule(char const * s, tz_rule_t * const rule)
+{
+    uint value;
+    memset(rule, 0, sizeof(tz_rule_t));
+    if (*s == 'J') {
+        rule->type = 'J';
+        if (!(s = _parse_num(s + 1, 365, &value)) || value < 1) {
+            return NULL;
+        }
+        rule->day = value;
+    } else if (*s == 'M') {
+        rule->type = 'M';
+        uint month, week, day;
+        if (!(s = _parse_num(s + 1, 12, &month)) || month < 1 || *s != '.' ||
+            !(s = _parse_num(s + 1, 5, &week)) || week < 1 || *s != '.' ||
+            !(s = _parse_num(s + 1, 6, &day))) {
+            return NULL;
+        }
+        rule->month = month;
+        rule->week = week;
+        rule->day = day;
+    } else {
+        rule->type = 'D';
+        if (!(s = _parse_num(s, 365, &value))) {
+            return NULL;
+        }
+        rule->day = value;
+    }
+    rule->time = _default_time;
+    if (*s == '/') {
+        s = _parse_time(s + 1, &rule->time);
+    }
+    return s;
+}
+
+static bool
+_parse(tz_t * const tz, char const * s)
+{
+    int32_t secs;
+    if (!(s = _parse_name(s)) || !(s = _parse_time(s, &secs))) {
+        return false;
+    }
+    tz->std_offset = -secs;  // POSIX offsets count west of Greenwich
+    if (!*s) {
+        return true;
+    }
+    if (!(s = _parse_name(s))) {
+        return false;
+    }
+    tz->has_dst = true;
+    tz->dst_offset = tz->std_offset + 3600;
+    if (*s && *s != ',') {
+        if (!(s = _parse_time(s, &secs))) {
+            return false;
+        }
+        tz->dst_offset = -secs;
+    }
+    if (!*s) {  // no rule, use the US one like newlib does
+        s = ",M3.2.0,M11.1.0";
+    }
+    if (*s != ',' || !(s = _parse_rule(s + 1, &tz->start)) ||
+        *s != ',' || !(s = _parse_rule(s + 1, &tz->end))) {
+        return false;
+    }
+    return *s == '\0';
+}
+
+// day of the rule in `year`, in days since 1970-01-01
+static int32_t
+_rule_day(tz_rule_t const * const rule, int const year)
+{
+    int32_t const jan1 = tz_days_from_civil(year, 1, 1);
+    switch (rule->type) {
+        case 'J':
+            return jan1 + rule->day - 1 + (_is_leap(year) && rule->day >= 60);
+        case 'D':
+            return jan1 + rule->day;
+        default: {
+            int32_t const first = tz_days_from_civil(year, rule->month, 1);
+            uint const wday = ((first + 4) % 7 + 7) % 7;
+            uint day = (rule->day + 7 - wday) % 7 + (rule->week - 1) * 7;  // week 5 means the last one
+            while (day >= _month_len(year, rule->month)) {
+                day -= 7;
+            }
+            return first + day;
+        }
+    }
+}
+
+static void
+_compile(tz_t * const tz, int const year)
+{
+    tz->year = year;
+    tz->from = (time_t)tz_days_from_civil(year, 1, 1) * 86400 - 86400;
+    tz->until = (time_t)tz_days_from_civil(year + 2, 1, 1) * 86400 - 86400;
+    tz->base_offset = tz->std_offset;
+    tz->base_isdst = false;
+    tz->edges_len = 0;
+    if (!tz->has_dst) {
+        return;
+    }
+    for (int y = year; y <= year + 1; y++) {
+        // DST starts at a local standard time, and ends at a local daylight time
+        tz_edge_t const start = {
+            .at = (time_t)_rule_day(&tz->start, y) * 86400 + tz->start.time - tz->std_offset,
+            .offset = tz->dst_offset,
+            .isdst = true
+        };
+        tz_edge_t const end = {
+            .at = (time_t)_rule_day(&tz->end, y) * 86400 + tz->end.time - tz->dst_offset,
+            .offset = tz->std_offset,
+            .isdst = false
+        };
+        if (y == year && start.at > end.at) {  // southern hemisphere, DST at new year
+            tz->base_offset = tz->dst_offset;
+            tz->base_isdst = true;
+        }
+        tz->edges[tz->edges_len++] = start.at < end.at ? start : end;
+        tz->edges[tz->edges_len++] = start.at < end.at ? end : start;
+    }
+}
+
+// Parse the POSIX TZ string.  Without one, or when it can't be parsed, it is UTC.
+bool
+tz_init(tz_t * const tz, char const * const posix)
+{
+    memset(tz, 0, sizeof(tz_t));
+    bool const ok = !posix || !*posix || _parse(tz, posix);
+    if (!ok) {
+        memset(tz, 0, sizeof(tz_t));
+    }
+    return ok;
+}
+
+// Seconds that local time is ahead of UTC at `t`.  Optionally returns the span in
+// which that holds, limited to the table, and whether DST applies.
+int32_t
+tz_lookup(tz_t * const tz, time_t const t, time_t * const since, time_t * const until, bool * const isdst)
+{
+    if (t < tz->from || t >= tz->until) {
+        int y;
+        uint m, d;
+        _civil_from_days(_floor_div(t + tz->std_offset, 86400), &y, &m, &d);
+        _compile(tz, y);
+    }
+    uint ii = 0;
+    while (ii < tz->edges_len && tz->edges[ii].at <= t) {
+        ii++;
+    }
+    if (since) {
+        *since = ii ? tz->edges[ii - 1].at : tz->from;
+    }
+    if (until) {
+        *until = ii < tz->edges_len ? tz->edges[ii].at : tz->until;
+    }
+    if (isdst) {
+        *isdst = ii ? tz->edges[ii - 1].isdst : tz->base_isdst;
+    }
+    return ii ? tz->edges[ii - 1].offset : tz->base_offset;
+}
+
+// like localtime_r()
+void
+tz_localtime(tz_t * const tz, time_t const t, struct tm * const tm)
+{
+    bool isdst;
+    int32_t const offset = tz_lookup(tz, t, NULL, NULL, &isdst);
+    _breakdown(t + offset, isdst, tm);
+}
+
+// Local time at `now`.  When the clock moves forward by less than a day, and no DST
+// edge is crossed, the previous broken-down time is carried forward.
+struct tm const *
+tz_clock_advance(tz_t * const tz, tz_clock_t * const clock, time_t const now)
+{
+    time_t const delta = now - clock->t;
+    if (!clock->t || delta < 0 || delta >= 86400 || now >= clock->until) {
+        bool isdst;
+        int32_t const offset = tz_lookup(tz, now, NULL, &clock->until, &isdst);
+        _breakdown(now + offset, isdst, &clock->tm);
+        clock->t = now;
+        return &clock->tm;
+    }
+    struct tm * const tm = &clock->tm;
+    clock->t = now;
+    tm->tm_sec += delta;
+    tm->tm_min += tm->tm_sec / 60;
+    tm->tm_sec %= 60;
+    tm->tm_hour += tm->tm_min / 60;
+    tm->tm_min %= 60;
+    if (tm->tm_hour < 24) {
+        return tm;
+    }
+    tm->tm_hour -= 24;  // less than a day, so at most one day carries
+    tm->tm_wday = (tm->tm_wday + 1) % 7;
+    tm->tm_yday++;
+    if (++tm->tm_mday > (int)_month_len(tm->tm_year + 1900, tm->tm_mon + 1)) {
+        tm->tm_mday = 1;
+        if (++tm->tm_mon == 12) {
+            tm->tm_mon = 0;
+            tm->tm_year++;
+            tm->tm_yday = 0;
+        }
+    }
+    return tm;
+}
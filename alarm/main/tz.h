@@ -0,0 +1,47 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+#include <time.h>
+#include <sys/types.h>
+
+#define TZ_EDGES (4)  // DST starts and ends, for this year and next
+
+typedef struct tz_edge_t {
+    time_t at;       // UTC
+    int32_t offset;  // seconds that local time is ahead of UTC, from `at` on
+    bool isdst;
+} tz_edge_t;
+
+typedef struct tz_rule_t {
+    char type;       // 'J' (1..365, no Feb 29), 'D' (0..365) or 'M' (month.week.day)
+    uint16_t day;
+    uint8_t week, month;
+    int32_t time;    // local time of day [s], may be negative or past 24 h
+} tz_rule_t;
+
+typedef struct tz_t {
+    // compiled from the POSIX TZ string
+    int32_t std_offset, dst_offset;
+    bool has_dst;
+    tz_rule_t start, end;
+
+    // transitions for `year` and the next, valid for UTC times in [from, until)
+    int year;
+    time_t from, until;
+    int32_t base_offset;  // before the first edge
+    bool base_isdst;
+    tz_edge_t edges[TZ_EDGES];
+    uint8_t edges_len;
+} tz_t;
+
+typedef struct tz_clock_t {
+    time_t t;       // 0 until first advanced
+    time_t until;   // next DST edge, or the end of the table
+    struct tm tm;   // local time at `t`
+} tz_clock_t;
+
+int32_t tz_days_from_civil(int32_t y, uint const m, uint const d);
+bool tz_init(tz_t * const tz, char const * const posix);
+int32_t tz_lookup(tz_t * const tz, time_t const t, time_t * const since, time_t * const until, bool * const isdst);
+void tz_localtime(tz_t * const tz, time_t const t, struct tm * const tm);
+struct tm const * tz_clock_advance(tz_t * const tz, tz_clock_t * const clock, time_t const now);
@@ -0,0 +1,74 @@
+/**
+ * @brief fuzz_calendar_json, libFuzzer entry point for the calendar JSON parser
+ *
+ * © Copyright 2016, 2022, Sander and Coert Vonk
+ *
+ * This file is part of CALalarm.
+ *
+ * CALalarm is free software: you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * CALalarm is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with CALalarm.
+ * If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ **/
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <assert.h>
+
+#include "calendar_json.h"
+#include "tz.h"
+
+// Build with clang and -DCALALARM_FUZZ=ON, then start from the seeds that test_calendar_json
+// replays:
+//
+//   ./fuzz_calendar_json -max_len=8192 ../../alarm/test/corpus/calendar_json
+//
+// Each input is parsed in one go, and in the chunk sizes its first byte picks.  Under
+// ASan and UBSan, an overrun of the records or the arena shows up as a crash; the
+// asserts catch results that depend on how the payload was split.
+
+static bool
+_same_str(char const * const a, char const * const b)
+{
+    return a == b || (a && b && strcmp(a, b) == 0);
+}
+
+int
+LLVMFuzzerTestOneInput(uint8_t const * const data, size_t const size)
+{
+    static calendar_json_payload_t whole, chunked;
+    static tz_t tz;
+    static bool tz_done;
+    if (!tz_done) {
+        tz_done = tz_init(&tz, "CET-1CEST,M3.5.0,M10.5.0/3");
+    }
+    size_t const chunk = size ? 1 + data[0] % 64 : 1;
+
+    calendar_json_payload_init(&whole, &tz);
+    calendar_json_feed(&whole.json, (char const *)data, size);
+    calendar_json_payload_init(&chunked, &tz);
+    for (size_t ii = 0; ii < size; ii += chunk) {
+        calendar_json_feed(&chunked.json, (char const *)data + ii, ii + chunk < size ? chunk : size - ii);
+    }
+
+    calendar_json_t const * const a = &whole.json;
+    calendar_json_t const * const b = &chunked.json;
+    assert(calendar_json_status(a) == calendar_json_status(b));
+    assert(a->time == b->time && a->events_len == b->events_len && a->events_dropped == b->events_dropped);
+    assert(_same_str(a->pushId, b->pushId) && _same_str(a->hash, b->hash));
+    assert(a->events_len <= a->events_max && a->arena_len <= a->arena_size);
+    for (uint ii = 0; ii < a->events_len; ii++) {
+        assert(a->events[ii].alarm == b->events[ii].alarm && a->events[ii].start == b->events[ii].start);
+        assert(a->events[ii].stop == b->events[ii].stop && _same_str(a->events[ii].title, b->events[ii].title));
+    }
+    return 0;
+}
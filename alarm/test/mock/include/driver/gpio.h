@@ -0,0 +1,19 @@
+#pragma once
+#include "esp_err.h"
+
+typedef int gpio_num_t;
+
+typedef enum {
+    GPIO_MODE_INPUT = 1,
+    GPIO_MODE_OUTPUT = 2
+} gpio_mode_t;
+
+typedef enum {
+    GPIO_PULLUP_DISABLE = 0,
+    GPIO_PULLUP_ENABLE = 1
+} gpio_pullup_t;
+
+esp_err_t gpio_reset_pin(gpio_num_t const gpio);
+esp_err_t gpio_set_direction(gpio_num_t const gpio, gpio_mode_t const mode);
+esp_err_t gpio_set_level(gpio_num_t const gpio, uint32_t const level);
+int gpio_get_level(gpio_num_t const gpio);
@@ -0,0 +1,66 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "esp_err.h"
+#include "freertos/FreeRTOS.h"
+#include "driver/gpio.h"
+
+// Master writes of the ESP-IDF 4.4 I2C driver.  Like the real one, a command link
+// only keeps pointers to the data written, so it must stay put until
+// i2c_master_cmd_begin().  The bytes go to the emulated panel (mock.h).
+
+typedef int i2c_port_t;
+#define I2C_NUM_0 (0)
+#define I2C_NUM_1 (1)
+
+typedef enum {
+    I2C_MODE_SLAVE = 0,
+    I2C_MODE_MASTER
+} i2c_mode_t;
+
+typedef enum {
+    I2C_MASTER_WRITE = 0,
+    I2C_MASTER_READ
+} i2c_rw_t;
+
+typedef struct {
+    i2c_mode_t mode;
+    int sda_io_num;
+    int scl_io_num;
+    bool sda_pullup_en;
+    bool scl_pullup_en;
+    union {
+        struct {
+            uint32_t clk_speed;
+        } master;
+    };
+    uint32_t clk_flags;
+} i2c_config_t;
+
+typedef void * i2c_cmd_handle_t;
+
+typedef struct mock_i2c_op_t {
+    enum { MOCK_I2C_START, MOCK_I2C_WRITE, MOCK_I2C_STOP } kind;
+    uint8_t byte;          // written by i2c_master_write_byte()
+    uint8_t const * data;  // or by i2c_master_write()
+    size_t len;
+} mock_i2c_op_t;
+
+typedef struct mock_i2c_link_t {
+    size_t ops_len, ops_max;
+    bool error;  // an op didn't fit
+    mock_i2c_op_t ops[];
+} mock_i2c_link_t;
+
+#define I2C_LINK_RECOMMENDED_SIZE(TRANSACTIONS) (sizeof(mock_i2c_link_t) + (TRANSACTIONS) * sizeof(mock_i2c_op_t))
+
+esp_err_t i2c_param_config(i2c_port_t const port, i2c_config_t const * const config);
+esp_err_t i2c_driver_install(i2c_port_t const port, i2c_mode_t const mode, size_t const slv_rx_buf_len, size_t const slv_tx_buf_len, int const intr_alloc_flags);
+i2c_cmd_handle_t i2c_cmd_link_create_static(uint8_t * const buffer, uint32_t const size);
+void i2c_cmd_link_delete_static(i2c_cmd_handle_t const cmd);
+esp_err_t i2c_master_start(i2c_cmd_handle_t const cmd);
+esp_err_t i2c_master_write_byte(i2c_cmd_handle_t const cmd, uint8_t const data, bool const ack_en);
+esp_err_t i2c_master_write(i2c_cmd_handle_t const cmd, uint8_t const * const data, size_t const data_len, bool const ack_en);
+esp_err_t i2c_master_stop(i2c_cmd_handle_t const cmd);
+esp_err_t i2c_master_cmd_begin(i2c_port_t const port, i2c_cmd_handle_t const cmd, TickType_t const ticks_to_wait);
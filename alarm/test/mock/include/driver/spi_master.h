@@ -0,0 +1,72 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "esp_err.h"
+#include "freertos/FreeRTOS.h"
+
+// Queued transactions of the ESP-IDF 4.4 SPI master driver.  A queued transaction
+// goes out when its result is collected, the latest the real DMA could read its
+// buffer.  The pre-transfer callback runs right before, and the level of the
+// DC line (mock_spi_set_dc) decides if the bytes are commands or data.
+
+typedef enum {
+    SPI1_HOST = 0,
+    SPI2_HOST = 1,
+    SPI3_HOST = 2
+} spi_host_device_t;
+
+#define HSPI_HOST SPI2_HOST
+#define VSPI_HOST SPI3_HOST
+#define SPI_DMA_CH_AUTO (3)
+
+typedef struct {
+    int mosi_io_num;
+    int miso_io_num;
+    int sclk_io_num;
+    int quadwp_io_num;
+    int quadhd_io_num;
+    int max_transfer_sz;
+    uint32_t flags;
+} spi_bus_config_t;
+
+typedef struct spi_transaction_t spi_transaction_t;
+typedef void (* transaction_cb_t)(spi_transaction_t * trans);
+
+struct spi_transaction_t {
+    uint32_t flags;
+    uint16_t cmd;
+    uint64_t addr;
+    size_t length;    // [bits]
+    size_t rxlength;
+    void * user;
+    union {
+        void const * tx_buffer;
+        uint8_t tx_data[4];
+    };
+    union {
+        void * rx_buffer;
+        uint8_t rx_data[4];
+    };
+};
+
+typedef struct {
+    uint8_t command_bits;
+    uint8_t address_bits;
+    uint8_t dummy_bits;
+    uint8_t mode;
+    int clock_speed_hz;
+    int spics_io_num;
+    uint32_t flags;
+    int queue_size;
+    transaction_cb_t pre_cb;
+    transaction_cb_t post_cb;
+} spi_device_interface_config_t;
+
+typedef struct mock_spi_device_t * spi_device_handle_t;
+
+esp_err_t spi_bus_initialize(spi_host_device_t const host, spi_bus_config_t const * const config, int const dma_chan);
+esp_err_t spi_bus_add_device(spi_host_device_t const host, spi_device_interface_config_t const * const config, spi_device_handle_t * const handle);
+esp_err_t spi_device_queue_trans(spi_device_handle_t const handle, spi_transaction_t * const trans, TickType_t const ticks_to_wait);
+esp_err_t spi_device_get_trans_result(spi_device_handle_t const handle, spi_transaction_t ** const trans, TickType_t const ticks_to_wait);
+esp_err_t spi_device_transmit(spi_device_handle_t const handle, spi_transaction_t * const trans);
@@ -0,0 +1,20 @@
+#pragma once
+#include <stdio.h>
+#include <stdlib.h>
+
+typedef int esp_err_t;
+
+#define ESP_OK (0)
+#define ESP_FAIL (-1)
+#define ESP_ERR_NO_MEM (0x101)
+#define ESP_ERR_INVALID_ARG (0x102)
+#define ESP_ERR_INVALID_STATE (0x103)
+#define ESP_ERR_TIMEOUT (0x107)
+
+#define ESP_ERROR_CHECK(x) do {                                              \
+        esp_err_t const _rc = (x);                                           \
+        if (_rc != ESP_OK) {                                                 \
+            fprintf(stderr, "%s:%d: %s = 0x%x\n", __FILE__, __LINE__, #x, _rc); \
+            abort();                                                         \
+        }                                                                    \
+    } while (0)
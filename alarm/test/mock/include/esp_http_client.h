@@ -0,0 +1,46 @@
+#pragma once
+#include <stdbool.h>
+#include "esp_err.h"
+
+// the part of esp_http_client that https_fetch.c uses, served by mock_http.c
+
+typedef struct esp_http_client * esp_http_client_handle_t;
+
+typedef enum {
+    HTTP_EVENT_ERROR,
+    HTTP_EVENT_ON_CONNECTED,
+    HTTP_EVENT_HEADERS_SENT,
+    HTTP_EVENT_HEADER_SENT = HTTP_EVENT_HEADERS_SENT,
+    HTTP_EVENT_ON_HEADER,
+    HTTP_EVENT_ON_DATA,
+    HTTP_EVENT_ON_FINISH,
+    HTTP_EVENT_DISCONNECTED,
+} esp_http_client_event_id_t;
+
+typedef struct esp_http_client_event {
+    esp_http_client_event_id_t event_id;
+    esp_http_client_handle_t client;
+    void * data;
+    int data_len;
+    void * user_data;
+    char * header_key;
+    char * header_value;
+} esp_http_client_event_t;
+
+typedef esp_err_t (* http_event_handle_cb)(esp_http_client_event_t * evt);
+
+typedef struct {
+    char const * url;
+    http_event_handle_cb event_handler;
+    void * user_data;
+    int buffer_size;
+    bool disable_auto_redirect;
+    bool keep_alive_enable;
+} esp_http_client_config_t;
+
+esp_http_client_handle_t esp_http_client_init(esp_http_client_config_t const * config);
+esp_err_t esp_http_client_set_url(esp_http_client_handle_t client, char const * url);
+esp_err_t esp_http_client_perform(esp_http_client_handle_t client);
+esp_err_t esp_http_client_close(esp_http_client_handle_t client);
+esp_err_t esp_http_client_cleanup(esp_http_client_handle_t client);
+int esp_http_client_get_status_code(esp_http_client_handle_t client);
@@ -0,0 +1,6 @@
+#pragma once
+#include "freertos/FreeRTOS.h"
+
+// time only passes when a task delays, so runs are repeatable
+void vTaskDelay(TickType_t const ticks);
+TickType_t xTaskGetTickCount(void);
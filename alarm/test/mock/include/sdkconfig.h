@@ -0,0 +1,12 @@
+#pragma once
+
+// The options the alarm is built with (sdkconfig.defaults), for the host build
+
+#define CONFIG_IDF_TARGET_ESP32 1
+#define CONFIG_FREERTOS_HZ 100
+#define CONFIG_SSD1306_I2C_INTERFACE 1
+#define CONFIG_SSD1306_SSD1306_128x32 1
+#define CONFIG_SSD1306_OFFSETX 0
+#define CONFIG_SSD1306_SCL_GPIO 22
+#define CONFIG_SSD1306_SDA_GPIO 23
+#define CONFIG_SSD1306_RESET_GPIO -1
@@ -0,0 +1,24 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+#include "ssd1306_emu.h"
+
+// Stand-ins for the ESP-IDF drivers that the ssd1306 component uses, so it runs on a
+// host.  Both buses lead to the same emulated panel.
+
+typedef struct mock_stats_t {
+    uint32_t errors;      // driver calls that the real driver would have failed
+    uint32_t queued_max;  // most SPI transactions in the queue at once
+} mock_stats_t;
+
+extern ssd1306_emu_t mock_panel;
+extern mock_stats_t mock_stats;
+
+void mock_reset(void);
+void mock_spi_set_dc(int const gpio);
+void mock_fail(uint const transactions);  // the next ones fail, and don't reach the panel
+bool mock_failing(void);                  // for the buses, takes one of those failures
+
+// each bus resets its own state
+void mock_i2c_reset(void);
+void mock_spi_reset(void);
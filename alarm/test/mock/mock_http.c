@@ -0,0 +1,173 @@
+/**
+ * @brief mock_http, a stand-in for esp_http_client and the hosts behind the Apps Script URL
+ *
+ * © Copyright 2016, 2022, Sander and Coert Vonk
+ *
+ * This file is part of CALalarm.
+ *
+ * CALalarm is free software: you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * CALalarm is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with CALalarm.
+ * If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ **/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "esp_http_client.h"
+#include "mock_http.h"
+
+mock_http_t mock_http;
+
+struct esp_http_client {
+    esp_http_client_config_t config;
+    char url[1024];
+    int status;
+    int conn_host;         // host of the open connection, or -1
+    uint conn_generation;  // of that host, when the connection was made
+};
+
+void
+mock_http_reset(char const * const body, uint const chunk)
+{
+    memset(&mock_http, 0, sizeof(mock_http));
+    mock_http.hosts[0].name = MOCK_HTTP_SCRIPT;
+    mock_http.hosts[1].name = MOCK_HTTP_CONTENT;
+    mock_http.body = body;
+    mock_http.chunk = chunk;
+}
+
+void
+mock_http_close_idle(void)
+{
+    for (uint ii = 0; ii < MOCK_HTTP_HOSTS; ii++) {
+        mock_http.hosts[ii].generation++;
+    }
+}
+
+// index of the host in "https://host/path", or -1 when DNS doesn't know it
+static int
+_host(char const * const url)
+{
+    char const * const name = strncmp(url, "https://", 8) == 0 ? url + 8 : url;
+    size_t const len = strcspn(name, "/?");
+    for (int ii = 0; ii < MOCK_HTTP_HOSTS; ii++) {
+        if (strlen(mock_http.hosts[ii].name) == len && strncmp(name, mock_http.hosts[ii].name, len) == 0) {
+            return ii;
+        }
+    }
+    return -1;
+}
+
+static void
+_event(esp_http_client_handle_t const client, esp_http_client_event_id_t const id, char const * const key, char const * const value, char const * const data, int const len)
+{
+    esp_http_client_event_t evt = {
+        .event_id = id,
+        .client = client,
+        .data = (void *)data,
+        .data_len = len,
+        .user_data = client->config.user_data,
+        .header_key = (char *)key,
+        .header_value = (char *)value,
+    };
+    client->config.event_handler(&evt);
+}
+
+esp_http_client_handle_t
+esp_http_client_init(esp_http_client_config_t const * const config)
+{
+    esp_http_client_handle_t const client = calloc(1, sizeof(struct esp_http_client));
+    client->config = *config;
+    client->conn_host = -1;
+    snprintf(client->url, sizeof(client->url), "%s", config->url);
+    return client;
+}
+
+esp_err_t
+esp_http_client_set_url(esp_http_client_handle_t const client, char const * const url)
+{
+    snprintf(client->url, sizeof(client->url), "%s", url);
+    return ESP_OK;
+}
+
+esp_err_t
+esp_http_client_close(esp_http_client_handle_t const client)
+{
+    client->conn_host = -1;
+    return ESP_OK;
+}
+
+esp_err_t
+esp_http_client_cleanup(esp_http_client_handle_t const client)
+{
+    free(client);
+    return ESP_OK;
+}
+
+int
+esp_http_client_get_status_code(esp_http_client_handle_t const client)
+{
+    return client->status;
+}
+
+// Like the real one: a connection to another host is replaced, and a request on a
+// connection that the server closed fails after the headers were sent.
+esp_err_t
+esp_http_client_perform(esp_http_client_handle_t const client)
+{
+    client->status = 0;
+    int const host = _host(client->url);
+    if (host < 0) {
+        client->conn_host = -1;
+        return ESP_FAIL;
+    }
+    if (client->conn_host != host) {
+        mock_http.hosts[host].lookups++;
+        mock_http.hosts[host].handshakes++;
+        client->conn_host = host;
+        client->conn_generation = mock_http.hosts[host].generation;
+        _event(client, HTTP_EVENT_ON_CONNECTED, NULL, NULL, NULL, 0);
+    }
+    mock_http_host_t * const h = &mock_http.hosts[host];
+    _event(client, HTTP_EVENT_HEADER_SENT, NULL, NULL, NULL, 0);
+    if (client->conn_generation != h->generation) {
+        client->conn_host = -1;
+        return ESP_FAIL;
+    }
+    h->requests++;
+
+    if (host == 0 || mock_http.redirect_loop) {
+        client->status = 302;
+        _event(client, HTTP_EVENT_ON_HEADER, "Content-Type", "text/html; charset=UTF-8", NULL, 0);
+        _event(client, HTTP_EVENT_ON_HEADER, "Location", "https://" MOCK_HTTP_CONTENT "/macros/echo?user_content_key=k3y", NULL, 0);
+        char const moved[] = "<HTML><BODY>Moved Temporarily</BODY></HTML>";
+        _event(client, HTTP_EVENT_ON_DATA, NULL, NULL, moved, sizeof(moved) - 1);
+    } else {
+        client->status = 200;
+        _event(client, HTTP_EVENT_ON_HEADER, "Content-Type", "application/json; charset=utf-8", NULL, 0);
+        size_t const len = strlen(mock_http.body);
+        for (size_t ii = 0; ii < len; ii += mock_http.chunk) {
+            if (mock_http.drop_after && ii >= mock_http.drop_after) {
+                mock_http.drop_after = 0;
+                client->conn_host = -1;
+                return ESP_FAIL;
+            }
+            _event(client, HTTP_EVENT_ON_DATA, NULL, NULL, mock_http.body + ii, ii + mock_http.chunk < len ? mock_http.chunk : len - ii);
+        }
+    }
+    _event(client, HTTP_EVENT_ON_FINISH, NULL, NULL, NULL, 0);
+    if (!client->config.keep_alive_enable) {
+        client->conn_host = -1;
+    }
+    return ESP_OK;
+}
@@ -0,0 +1,34 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+#include <sys/types.h>
+
+// A stand-in for the two hosts behind the Apps Script URL, behind esp_http_client.  The
+// script host answers with a redirect to the content host, that answers with `body`.
+// Each counts what a connection costs, so a test can tell a reused connection from a
+// new one.
+
+#define MOCK_HTTP_SCRIPT "script.google.com"
+#define MOCK_HTTP_CONTENT "script.googleusercontent.com"
+#define MOCK_HTTP_HOSTS (2)
+
+typedef struct mock_http_host_t {
+    char const * name;
+    uint lookups;     // DNS
+    uint handshakes;  // TCP and TLS, one for each new connection
+    uint requests;
+    uint generation;  // bumped when the server closes its idle connections
+} mock_http_host_t;
+
+typedef struct mock_http_t {
+    mock_http_host_t hosts[MOCK_HTTP_HOSTS];
+    char const * body;      // of the content host
+    uint chunk;             // it arrives in pieces of this many bytes
+    bool redirect_loop;     // the content host redirects to itself
+    uint drop_after;        // once, the content host drops the connection after this many bytes of the body
+} mock_http_t;
+
+extern mock_http_t mock_http;
+
+void mock_http_reset(char const * const body, uint const chunk);
+void mock_http_close_idle(void);  // the servers close the idle keep-alive connections
@@ -0,0 +1,172 @@
+/**
+ * @brief mock_i2c, host stand-in for the I2C master driver, that writes to the emulated panel
+ *
+ * © Copyright 2016, 2022, Sander and Coert Vonk
+ *
+ * This file is part of CALalarm.
+ *
+ * CALalarm is free software: you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * CALalarm is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with CALalarm.
+ * If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ **/
+
+#include <string.h>
+
+#include "driver/i2c.h"
+#include "mock.h"
+
+#define MOCK_I2C_BYTES (1024)  // longest START..STOP sequence
+
+static struct {
+    uint32_t clk_hz;  // 0 until configured
+    bool installed;
+} _i2c;
+
+void
+mock_i2c_reset(void)
+{
+    memset(&_i2c, 0, sizeof(_i2c));
+}
+
+esp_err_t
+i2c_param_config(i2c_port_t const port, i2c_config_t const * const config)
+{
+    if (port != I2C_NUM_0 || config->mode != I2C_MODE_MASTER || config->master.clk_speed == 0) {
+        mock_stats.errors++;
+        return ESP_ERR_INVALID_ARG;
+    }
+    _i2c.clk_hz = config->master.clk_speed;
+    return ESP_OK;
+}
+
+esp_err_t
+i2c_driver_install(i2c_port_t const port, i2c_mode_t const mode, size_t const slv_rx_buf_len, size_t const slv_tx_buf_len, int const intr_alloc_flags)
+{
+    (void)slv_rx_buf_len; (void)slv_tx_buf_len; (void)intr_alloc_flags;
+    if (port != I2C_NUM_0 || mode != I2C_MODE_MASTER || _i2c.installed) {
+        mock_stats.errors++;
+        return ESP_FAIL;
+    }
+    _i2c.installed = true;
+    return ESP_OK;
+}
+
+i2c_cmd_handle_t
+i2c_cmd_link_create_static(uint8_t * const buffer, uint32_t const size)
+{
+    if (buffer == NULL || size < sizeof(mock_i2c_link_t)) {
+        mock_stats.errors++;
+        return NULL;
+    }
+    mock_i2c_link_t * const link = (mock_i2c_link_t *)buffer;
+    link->ops_len = 0;
+    link->ops_max = (size - sizeof(mock_i2c_link_t)) / sizeof(mock_i2c_op_t);
+    link->error = false;
+    return link;
+}
+
+void
+i2c_cmd_link_delete_static(i2c_cmd_handle_t const cmd)
+{
+    (void)cmd;
+}
+
+static esp_err_t
+_add(i2c_cmd_handle_t const cmd, mock_i2c_op_t const op)
+{
+    mock_i2c_link_t * const link = cmd;
+    if (link->ops_len == link->ops_max) {
+        link->error = true;
+        mock_stats.errors++;
+        return ESP_ERR_NO_MEM;
+    }
+    link->ops[link->ops_len++] = op;
+    return ESP_OK;
+}
+
+esp_err_t
+i2c_master_start(i2c_cmd_handle_t const cmd)
+{
+    return _add(cmd, (mock_i2c_op_t){ .kind = MOCK_I2C_START });
+}
+
+esp_err_t
+i2c_master_write_byte(i2c_cmd_handle_t const cmd, uint8_t const data, bool const ack_en)
+{
+    (void)ack_en;
+    return _add(cmd, (mock_i2c_op_t){ .kind = MOCK_I2C_WRITE, .byte = data, .len = 1 });
+}
+
+esp_err_t
+i2c_master_write(i2c_cmd_handle_t const cmd, uint8_t const * const data, size_t const data_len, bool const ack_en)
+{
+    (void)ack_en;
+    if (data == NULL || data_len == 0) {
+        mock_stats.errors++;
+        return ESP_ERR_INVALID_ARG;
+    }
+    return _add(cmd, (mock_i2c_op_t){ .kind = MOCK_I2C_WRITE, .data = data, .len = data_len });
+}
+
+esp_err_t
+i2c_master_stop(i2c_cmd_handle_t const cmd)
+{
+    return _add(cmd, (mock_i2c_op_t){ .kind = MOCK_I2C_STOP });
+}
+
+// runs the link, each START..STOP sequence goes to the panel as one transaction
+esp_err_t
+i2c_master_cmd_begin(i2c_port_t const port, i2c_cmd_handle_t const cmd, TickType_t const ticks_to_wait)
+{
+    (void)ticks_to_wait;
+    mock_i2c_link_t const * const link = cmd;
+    if (port != I2C_NUM_0 || !_i2c.installed || _i2c.clk_hz == 0 || link->error) {
+        mock_stats.errors++;
+        return ESP_FAIL;
+    }
+    if (mock_failing()) {  // say, a NACK on the address byte
+        return ESP_FAIL;
+    }
+    static uint8_t bytes[MOCK_I2C_BYTES];
+    size_t len = 0;
+    bool started = false;
+    for (size_t ii = 0; ii < link->ops_len; ii++) {
+        mock_i2c_op_t const * const op = &link->ops[ii];
+        switch (op->kind) {
+            case MOCK_I2C_START:
+                started = true;
+                len = 0;
+                break;
+            case MOCK_I2C_WRITE:
+                if (!started || len + op->len > sizeof(bytes)) {
+                    mock_stats.errors++;
+                    return ESP_FAIL;
+                }
+                memcpy(bytes + len, op->data ? op->data : &op->byte, op->len);
+                len += op->len;
+                break;
+            case MOCK_I2C_STOP:
+                if (!started) {
+                    mock_stats.errors++;
+                    return ESP_FAIL;
+                }
+                ssd1306_emu_i2c(&mock_panel, bytes, len, _i2c.clk_hz);
+                started = false;
+                break;
+        }
+    }
+    if (started) {  // never stopped
+        mock_stats.errors++;
+        return ESP_FAIL;
+    }
+    return ESP_OK;
+}
@@ -0,0 +1,125 @@
+/**
+ * @brief mock_idf, host stand-ins for the FreeRTOS, timer and GPIO calls
+ *
+ * © Copyright 2016, 2022, Sander and Coert Vonk
+ *
+ * This file is part of CALalarm.
+ *
+ * CALalarm is free software: you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * CALalarm is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with CALalarm.
+ * If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ **/
+
+#include <string.h>
+#include <time.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_timer.h"
+#include "driver/gpio.h"
+#include "mock.h"
+
+#define MOCK_GPIOS (64)
+
+ssd1306_emu_t mock_panel;
+mock_stats_t mock_stats;
+
+static TickType_t _ticks;
+static uint8_t _gpio_levels[MOCK_GPIOS];
+static uint _fail;
+
+// a fresh panel and buses, as after a power cycle
+void
+mock_reset(void)
+{
+    ssd1306_emu_reset(&mock_panel);
+    memset(&mock_stats, 0, sizeof(mock_stats));
+    memset(_gpio_levels, 0, sizeof(_gpio_levels));
+    mock_i2c_reset();
+    mock_spi_reset();
+    _fail = 0;
+}
+
+void
+mock_fail(uint const transactions)
+{
+    _fail = transactions;
+}
+
+bool
+mock_failing(void)
+{
+    if (_fail == 0) {
+        return false;
+    }
+    _fail--;
+    return true;
+}
+
+void
+vTaskDelay(TickType_t const ticks)
+{
+    _ticks += ticks;
+}
+
+TickType_t
+xTaskGetTickCount(void)
+{
+    return _ticks;
+}
+
+int64_t
+esp_timer_get_time(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static bool
+_gpio_valid(gpio_num_t const gpio)
+{
+    if (gpio < 0 || gpio >= MOCK_GPIOS) {
+        mock_stats.errors++;
+        return false;
+    }
+    return true;
+}
+
+esp_err_t
+gpio_reset_pin(gpio_num_t const gpio)
+{
+    if (!_gpio_valid(gpio)) return ESP_ERR_INVALID_ARG;
+    _gpio_levels[gpio] = 0;
+    return ESP_OK;
+}
+
+esp_err_t
+gpio_set_direction(gpio_num_t const gpio, gpio_mode_t const mode)
+{
+    (void)mode;
+    return _gpio_valid(gpio) ? ESP_OK : ESP_ERR_INVALID_ARG;
+}
+
+esp_err_t
+gpio_set_level(gpio_num_t const gpio, uint32_t const level)
+{
+    if (!_gpio_valid(gpio)) return ESP_ERR_INVALID_ARG;
+    _gpio_levels[gpio] = level ? 1 : 0;
+    return ESP_OK;
+}
+
+int
+gpio_get_level(gpio_num_t const gpio)
+{
+    return _gpio_valid(gpio) ? _gpio_levels[gpio] : 0;
+}
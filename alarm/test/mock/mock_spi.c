@@ -0,0 +1,136 @@
+/**
+ * @brief mock_spi, host stand-in for the SPI master driver, that writes to the emulated panel
+ *
+ * © Copyright 2016, 2022, Sander and Coert Vonk
+ *
+ * This file is part of CALalarm.
+ *
+ * CALalarm is free software: you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * CALalarm is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with CALalarm.
+ * If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ **/
+
+#include <string.h>
+
+#include "driver/spi_master.h"
+#include "driver/gpio.h"
+#include "mock.h"
+
+#define MOCK_SPI_QUEUE_MAX (64)
+
+struct mock_spi_device_t {
+    spi_device_interface_config_t config;
+    spi_transaction_t * queue[MOCK_SPI_QUEUE_MAX];  // in flight, oldest first
+    uint queued;
+};
+
+static struct {
+    bool bus;
+    bool added;
+    int dc;  // GPIO of the D/C# line, -1 when unknown
+    struct mock_spi_device_t device;
+} _spi;
+
+void
+mock_spi_reset(void)
+{
+    memset(&_spi, 0, sizeof(_spi));
+    _spi.dc = -1;
+}
+
+void
+mock_spi_set_dc(int const gpio)
+{
+    _spi.dc = gpio;
+}
+
+esp_err_t
+spi_bus_initialize(spi_host_device_t const host, spi_bus_config_t const * const config, int const dma_chan)
+{
+    (void)host; (void)config; (void)dma_chan;
+    if (_spi.bus) {
+        mock_stats.errors++;
+        return ESP_ERR_INVALID_STATE;
+    }
+    _spi.bus = true;
+    return ESP_OK;
+}
+
+esp_err_t
+spi_bus_add_device(spi_host_device_t const host, spi_device_interface_config_t const * const config, spi_device_handle_t * const handle)
+{
+    (void)host;
+    if (!_spi.bus || _spi.added || config->clock_speed_hz <= 0 ||
+        config->queue_size <= 0 || config->queue_size > MOCK_SPI_QUEUE_MAX) {
+        mock_stats.errors++;
+        return ESP_ERR_INVALID_ARG;
+    }
+    _spi.added = true;
+    _spi.device.config = *config;
+    _spi.device.queued = 0;
+    *handle = &_spi.device;
+    return ESP_OK;
+}
+
+esp_err_t
+spi_device_queue_trans(spi_device_handle_t const handle, spi_transaction_t * const trans, TickType_t const ticks_to_wait)
+{
+    (void)ticks_to_wait;  // a full queue would block forever, as nothing drains it
+    if (handle != &_spi.device || trans->length % 8 || trans->tx_buffer == NULL ||
+        handle->queued == (uint)handle->config.queue_size) {
+        mock_stats.errors++;
+        return ESP_ERR_INVALID_STATE;
+    }
+    handle->queue[handle->queued++] = trans;
+    if (handle->queued > mock_stats.queued_max) {
+        mock_stats.queued_max = handle->queued;
+    }
+    return ESP_OK;
+}
+
+// The oldest transaction goes out now, so a driver that reuses a buffer before
+// collecting its result sends the wrong bytes, as it would with DMA.
+esp_err_t
+spi_device_get_trans_result(spi_device_handle_t const handle, spi_transaction_t ** const trans, TickType_t const ticks_to_wait)
+{
+    (void)ticks_to_wait;
+    if (handle != &_spi.device || handle->queued == 0 || _spi.dc < 0) {
+        mock_stats.errors++;
+        return ESP_ERR_TIMEOUT;
+    }
+    spi_transaction_t * const t = handle->queue[0];
+    memmove(handle->queue, handle->queue + 1, --handle->queued * sizeof(handle->queue[0]));
+    *trans = t;
+    if (mock_failing()) {
+        return ESP_FAIL;
+    }
+
+    if (handle->config.pre_cb) {
+        handle->config.pre_cb(t);
+    }
+    ssd1306_emu_spi(&mock_panel, gpio_get_level(_spi.dc), t->tx_buffer, t->length / 8, handle->config.clock_speed_hz);
+    if (handle->config.post_cb) {
+        handle->config.post_cb(t);
+    }
+    return ESP_OK;
+}
+
+esp_err_t
+spi_device_transmit(spi_device_handle_t const handle, spi_transaction_t * const trans)
+{
+    spi_transaction_t * done;
+    esp_err_t const err = spi_device_queue_trans(handle, trans, portMAX_DELAY);
+    if (err != ESP_OK) {
+        return err;
+    }
+    return spi_device_get_trans_result(handle, &done, portMAX_DELAY);
+}
@@ -0,0 +1,266 @@
+/**
+ * @brief ssd1306_emu, decodes the SSD1306 command and data stream into an emulated GDDRAM
+ *
+ * © Copyright 2016, 2022, Sander and Coert Vonk
+ *
+ * This file is part of CALalarm.
+ *
+ * CALalarm is free software: you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * CALalarm is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with CALalarm.
+ * If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ **/
+
+#include <string.h>
+
+#include "ssd1306_emu.h"
+
+// The mock I2C and SPI transports feed the bytes they carry to this emulator.  It
+// decodes them the way the controller does: the I2C control bytes (Co and D/C#
+// bits) or the SPI D/C# line tell commands from data, commands take their
+// parameter bytes, and data lands in GDDRAM at the page addressing pointer.  It
+// counts bus bytes, transactions and the time they take on the wire, and flags what
+// the datasheet forbids while a horizontal scroll is active (see command 2Fh): writing
+// the pages that scroll, and changing the scroll setup.  Writes to the other pages are
+// undefined by the datasheet too, but work on the panels we use, so they are only counted.
+// The image is what you see when looking at the panel as mounted, so with A1h and
+// C8h (how ssd1306_init() leaves it) column 0 is on the left and COM0 at the top.
+
+void
+ssd1306_emu_reset(ssd1306_emu_t * const emu)
+{
+    memset(emu, 0, sizeof(ssd1306_emu_t));
+    emu->contrast = 0x7F;
+    emu->mux = 63;
+}
+
+// parameter bytes that follow a command
+static uint8_t
+_args(uint8_t const cmd)
+{
+    switch (cmd) {
+        case 0x20: case 0x81: case 0x8D: case 0xA8:
+        case 0xD3: case 0xD5: case 0xD9: case 0xDA: case 0xDB:
+            return 1;
+        case 0x21: case 0x22: case 0xA3:
+            return 2;
+        case 0x29: case 0x2A:
+            return 5;
+        case 0x26: case 0x27:
+            return 6;
+        default:
+            return 0;
+    }
+}
+
+static void
+_execute(ssd1306_emu_t * const emu, uint8_t const cmd, uint8_t const * const args)
+{
+    emu->stats.commands++;
+
+    if (cmd <= 0x0F) {
+        emu->col = emu->col_start = (emu->col_start & 0xF0) | cmd;
+        return;
+    }
+    if (cmd <= 0x1F) {
+        emu->col = emu->col_start = (emu->col_start & 0x0F) | ((cmd & 0x0F) << 4);
+        return;
+    }
+    if (cmd >= 0x40 && cmd <= 0x7F) {
+        emu->start_line = cmd & 0x3F;
+        return;
+    }
+    if (cmd >= 0xB0 && cmd <= 0xB7) {
+        emu->page = cmd & 0x07;
+        return;
+    }
+    switch (cmd) {
+        case 0x20: emu->addr_mode = args[0] & 0x03; break;
+        case 0x81: emu->contrast = args[0]; break;
+        case 0xA0: case 0xA1: emu->seg_remap = cmd & 1; break;
+        case 0xC0: case 0xC8: emu->com_remap = cmd & 0x08; break;
+        case 0xA6: case 0xA7: emu->inverted = cmd & 1; break;
+        case 0xAE: case 0xAF: emu->on = cmd & 1; break;
+        case 0xA8: emu->mux = args[0] & 0x3F; break;
+        case 0xA4: case 0xA5: case 0xD3: case 0xD5: case 0xD9: case 0xDA: case 0xDB:
+        case 0x8D: case 0xE3: case 0x21: case 0x22: case 0xA3:
+            break;  // no effect on what the emulator shows
+        case 0x26: case 0x27:
+            if (emu->scroll.active) emu->stats.violations++;
+            emu->scroll.setup = cmd;
+            emu->scroll.start = args[1] & 0x07;
+            emu->scroll.interval = args[2] & 0x07;
+            emu->scroll.end = args[3] & 0x07;
+            break;
+        case 0x29: case 0x2A:  // vertical and horizontal, only the setup is checked
+            if (emu->scroll.active) emu->stats.violations++;
+            emu->scroll.setup = 0;
+            break;
+        case 0x2E: emu->scroll.active = false; break;
+        case 0x2F: emu->scroll.active = true; break;
+        default:
+            emu->stats.unknown++;
+            emu->stats.commands--;
+    }
+}
+
+void
+ssd1306_emu_command(ssd1306_emu_t * const emu, uint8_t const byte)
+{
+    if (emu->decode.need) {
+        emu->decode.args[emu->decode.len++] = byte;
+        if (emu->decode.len == emu->decode.need) {
+            emu->decode.need = 0;
+            _execute(emu, emu->decode.cmd, emu->decode.args);
+        }
+        return;
+    }
+    uint8_t const need = _args(byte);
+    if (need) {
+        emu->decode.cmd = byte;
+        emu->decode.len = 0;
+        emu->decode.need = need;
+        return;
+    }
+    _execute(emu, byte, NULL);
+}
+
+void
+ssd1306_emu_data(ssd1306_emu_t * const emu, uint8_t const byte)
+{
+    if (emu->addr_mode != 0x02) {  // only page addressing is used by the driver
+        emu->stats.unknown++;
+        return;
+    }
+    if (emu->scroll.active) {
+        if (emu->page >= emu->scroll.start && emu->page <= emu->scroll.end) {
+            emu->stats.violations++;
+        } else {
+            emu->stats.scroll_writes++;
+        }
+    }
+    emu->ram[emu->page][emu->col] = byte;
+    emu->stats.data++;
+
+    // at the end of the page, the column pointer goes back to the start address
+    if (++emu->col == SSD1306_EMU_COLS) {
+        emu->col = emu->col_start;
+    }
+}
+
+static void
+_wire(ssd1306_emu_t * const emu, size_t const bytes, uint32_t const bits, uint32_t const clk_hz)
+{
+    emu->stats.bytes += bytes;
+    emu->stats.transactions++;
+    emu->stats.wire_us += ((uint64_t)bits * 1000000 + clk_hz - 1) / clk_hz;
+}
+
+// one START..STOP sequence, starting with the address byte
+void
+ssd1306_emu_i2c(ssd1306_emu_t * const emu, uint8_t const * const bytes, size_t const len, uint32_t const clk_hz)
+{
+    // 9 clocks per byte (incl. ACK), plus START and STOP
+    _wire(emu, len, len * 9 + 2, clk_hz);
+
+    if (len == 0 || bytes[0] != (0x3C << 1)) {  // SA0 low, write
+        emu->stats.unknown += len;
+        return;
+    }
+    size_t ii = 1;
+    while (ii < len) {
+        uint8_t const control = bytes[ii++];
+        bool const single = control & 0x80;  // Co
+        bool const data = control & 0x40;    // D/C#
+        if (control & 0x3F) {
+            emu->stats.unknown++;
+        }
+        size_t const end = single ? ii + 1 : len;
+        for (; ii < end && ii < len; ii++) {
+            if (data) {
+                ssd1306_emu_data(emu, bytes[ii]);
+            } else {
+                ssd1306_emu_command(emu, bytes[ii]);
+            }
+        }
+    }
+}
+
+// one transaction, with the D/C# line at `dc` throughout
+void
+ssd1306_emu_spi(ssd1306_emu_t * const emu, bool const dc, uint8_t const * const bytes, size_t const len, uint32_t const clk_hz)
+{
+    _wire(emu, len, len * 8, clk_hz);
+
+    for (size_t ii = 0; ii < len; ii++) {
+        if (dc) {
+            ssd1306_emu_data(emu, bytes[ii]);
+        } else {
+            ssd1306_emu_command(emu, bytes[ii]);
+        }
+    }
+}
+
+// Let an active horizontal scroll move its pages by `steps` columns.  The controller
+// moves the GDDRAM contents itself, that is why a stopped scroll leaves them shifted.
+void
+ssd1306_emu_scroll(ssd1306_emu_t * const emu, uint const steps)
+{
+    if (!emu->scroll.active || !emu->scroll.setup) {
+        return;
+    }
+    // 27h moves the image left, so towards lower columns unless the segments are remapped
+    bool const to_lower = (emu->scroll.setup == 0x27) == emu->seg_remap;
+    for (uint step = 0; step < steps; step++) {
+        for (uint page = emu->scroll.start; page <= emu->scroll.end; page++) {
+            uint8_t * const r = emu->ram[page];
+            if (to_lower) {
+                uint8_t const first = r[0];
+                memmove(r, r + 1, SSD1306_EMU_COLS - 1);
+                r[SSD1306_EMU_COLS - 1] = first;
+            } else {
+                uint8_t const last = r[SSD1306_EMU_COLS - 1];
+                memmove(r + 1, r, SSD1306_EMU_COLS - 1);
+                r[0] = last;
+            }
+        }
+    }
+}
+
+uint
+ssd1306_emu_height(ssd1306_emu_t const * const emu)
+{
+    return emu->mux + 1;
+}
+
+bool
+ssd1306_emu_pixel(ssd1306_emu_t const * const emu, uint const x, uint const y)
+{
+    uint const height = ssd1306_emu_height(emu);
+    uint const col = emu->seg_remap ? x : SSD1306_EMU_COLS - 1 - x;
+    uint const row = (emu->com_remap ? y : height - 1 - y) + emu->start_line;
+    bool const on = (emu->ram[(row / 8) % SSD1306_EMU_PAGES][col] >> (row % 8)) & 1;
+    return on != emu->inverted;
+}
+
+// plain PBM, 1 is a lit pixel
+void
+ssd1306_emu_pbm(ssd1306_emu_t const * const emu, FILE * const f)
+{
+    uint const height = ssd1306_emu_height(emu);
+    fprintf(f, "P1\n%d %u\n", SSD1306_EMU_COLS, height);
+    for (uint y = 0; y < height; y++) {
+        for (uint x = 0; x < SSD1306_EMU_COLS; x++) {
+            fputc(emu->on && ssd1306_emu_pixel(emu, x, y) ? '1' : '0', f);
+        }
+        fputc('\n', f);
+    }
+}
@@ -0,0 +1,58 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <sys/types.h>
+
+#define SSD1306_EMU_PAGES (8)
+#define SSD1306_EMU_COLS (128)
+#define SSD1306_EMU_ARGS (6)  // most parameter bytes a command takes
+
+typedef struct ssd1306_emu_stats_t {
+    uint32_t bytes;         // clocked onto the bus, incl. address and control bytes
+    uint32_t transactions;  // I2C START..STOP sequences, or SPI transactions
+    uint32_t wire_us;       // at the bus clock, rounded up per transaction
+    uint32_t data;          // GDDRAM bytes written
+    uint32_t commands;      // commands decoded, not counting their parameters
+    uint32_t violations;    // writes to scrolling pages and scroll setups while scrolling
+    uint32_t scroll_writes; // writes to the other pages while scrolling
+    uint32_t unknown;       // bytes that weren't understood
+} ssd1306_emu_stats_t;
+
+typedef struct ssd1306_emu_t {
+    uint8_t ram[SSD1306_EMU_PAGES][SSD1306_EMU_COLS];  // GDDRAM, LSB is the top row of a page
+    uint8_t page, col, col_start;                      // page addressing mode
+    uint8_t addr_mode;
+    uint8_t contrast;
+    uint8_t mux;          // multiplex ratio, minus one
+    uint8_t start_line;
+    bool seg_remap;       // A1h, column 127 drives SEG0
+    bool com_remap;       // C8h, scans from COM[N-1] down
+    bool inverted;
+    bool on;
+
+    struct {
+        bool active;
+        uint8_t setup;    // 26h or 27h, 0 before one was set up
+        uint8_t start, end, interval;
+    } scroll;
+
+    struct {
+        uint8_t cmd;
+        uint8_t args[SSD1306_EMU_ARGS];
+        uint8_t len, need;
+    } decode;             // the command whose parameters are still coming
+
+    ssd1306_emu_stats_t stats;
+} ssd1306_emu_t;
+
+void ssd1306_emu_reset(ssd1306_emu_t * const emu);
+void ssd1306_emu_command(ssd1306_emu_t * const emu, uint8_t const byte);
+void ssd1306_emu_data(ssd1306_emu_t * const emu, uint8_t const byte);
+void ssd1306_emu_i2c(ssd1306_emu_t * const emu, uint8_t const * const bytes, size_t const len, uint32_t const clk_hz);
+void ssd1306_emu_spi(ssd1306_emu_t * const emu, bool const dc, uint8_t const * const bytes, size_t const len, uint32_t const clk_hz);
+void ssd1306_emu_scroll(ssd1306_emu_t * const emu, uint const steps);
+uint ssd1306_emu_height(ssd1306_emu_t const * const emu);
+bool ssd1306_emu_pixel(ssd1306_emu_t const * const emu, uint const x, uint const y);
+void ssd1306_emu_pbm(ssd1306_emu_t const * const emu, FILE * const f);
@@ -0,0 +1,41 @@
+#pragma once
+#include <stdio.h>
+#include <stdint.h>
+#include <time.h>
+
+// Each test program counts the checks that failed, and exits non-zero if there were any.
+
+static int test_failures;
+
+#define CHECK(cond) do {                                                            \
+        if (!(cond)) {                                                              \
+            fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+            test_failures++;                                                        \
+        }                                                                           \
+    } while (0)
+
+#define CHECK_EQ(a, b) do {                                                         \
+        long long const _a = (long long)(a), _b = (long long)(b);                   \
+        if (_a != _b) {                                                             \
+            fprintf(stderr, "%s:%d: CHECK_EQ(%s, %s) failed, %lld != %lld\n",       \
+                    __FILE__, __LINE__, #a, #b, _a, _b);                            \
+            test_failures++;                                                        \
+        }                                                                           \
+    } while (0)
+
+#define TEST_RUN(fn) do {                                                           \
+        int const _before = test_failures;                                          \
+        fn();                                                                       \
+        printf("%s %s\n", test_failures == _before ? "PASS" : "FAIL", #fn);         \
+    } while (0)
+
+#define TEST_EXIT() return test_failures ? 1 : 0
+
+// for the benchmarks, that print their numbers as a baseline
+static inline uint64_t
+test_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
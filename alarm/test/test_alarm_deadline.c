@@ -0,0 +1,226 @@
+/**
+ * @brief test_alarm_deadline, alarms across clock steps, DST and resyncs
+ *
+ * © Copyright 2016, 2022, Sander and Coert Vonk
+ *
+ * This file is part of CALalarm.
+ *
+ * CALalarm is free software: you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * CALalarm is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with CALalarm.
+ * If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ **/
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "alarm_deadline.h"
+#include "tz.h"
+#include "test.h"
+
+// A stand-in for alarm_timer.c: a one-shot timer on the monotonic clock, and a wall
+// clock that can be stepped.  Like display_task, the tests re-arm after the clock
+// changed, except where they check what happens when that comes late.
+
+#define S (1000000LL)
+
+typedef struct sim_t {
+    alarm_deadline_t ad;
+    int64_t mono_us;        // since boot
+    int64_t wall_offset_us; // wall clock minus `mono_us`
+    int64_t timer_us;       // monotonic time the timer goes off, or -1
+    uint fired;
+    int64_t fired_wall_us;  // wall clock at the last alarm
+} sim_t;
+
+static time_t const _t0 = 1700000000;  // 2023-11-14 22:13:20 UTC
+
+static int64_t
+_wall(sim_t const * const sim)
+{
+    return sim->mono_us + sim->wall_offset_us;
+}
+
+static void
+_sim_init(sim_t * const sim, time_t const wall)
+{
+    memset(sim, 0, sizeof(*sim));
+    alarm_deadline_init(&sim->ad);
+    sim->mono_us = 1000 * S;
+    sim->wall_offset_us = (int64_t)wall * S - sim->mono_us;
+    sim->timer_us = -1;
+}
+
+static void
+_start(sim_t * const sim, int64_t const delay_us)
+{
+    sim->timer_us = delay_us == ALARM_DEADLINE_NONE ? -1 : sim->mono_us + delay_us;
+}
+
+static void
+_arm(sim_t * const sim, time_t const alarm)
+{
+    _start(sim, alarm_deadline_arm(&sim->ad, alarm, _wall(sim)));
+}
+
+// let `us` pass on the monotonic clock
+static void
+_run(sim_t * const sim, int64_t const us)
+{
+    int64_t const until = sim->mono_us + us;
+    while (sim->timer_us >= 0 && sim->timer_us <= until) {
+        sim->mono_us = sim->timer_us;
+        bool fire;
+        _start(sim, alarm_deadline_expired(&sim->ad, _wall(sim), &fire));
+        if (fire) {
+            sim->fired++;
+            sim->fired_wall_us = _wall(sim);
+        }
+    }
+    sim->mono_us = until;
+}
+
+static void
+_step_clock(sim_t * const sim, int64_t const us)
+{
+    sim->wall_offset_us += us;
+}
+
+static void
+test_on_time(void)
+{
+    sim_t sim;
+    _sim_init(&sim, _t0);
+    _arm(&sim, _t0 + 60);
+    _run(&sim, 59 * S);
+    CHECK_EQ(sim.fired, 0);
+    _run(&sim, 1 * S);
+    CHECK_EQ(sim.fired, 1);
+    CHECK_EQ(sim.fired_wall_us, (_t0 + 60) * S);
+    CHECK_EQ(sim.ad.last_fired, _t0 + 60);
+    _run(&sim, 3600 * S);
+    CHECK_EQ(sim.fired, 1);
+
+    // nothing armed, nothing goes off
+    _arm(&sim, 0);
+    CHECK_EQ(sim.timer_us, -1);
+}
+
+// set back before the timer went off, and nobody re-armed it yet: it waits for the rest
+static void
+test_set_back(void)
+{
+    sim_t sim;
+    _sim_init(&sim, _t0);
+    _arm(&sim, _t0 + 60);
+    _run(&sim, 20 * S);
+    _step_clock(&sim, -30 * S);
+    _run(&sim, 40 * S);  // the timer went off, but by the wall clock it is 30 s early
+    CHECK_EQ(sim.fired, 0);
+    CHECK(sim.timer_us >= 0);
+    _run(&sim, 30 * S);
+    CHECK_EQ(sim.fired, 1);
+    CHECK_EQ(sim.fired_wall_us, (_t0 + 60) * S);
+}
+
+// set forward past the alarm: within the grace period it still goes off, right away
+static void
+test_set_forward(void)
+{
+    sim_t sim;
+    _sim_init(&sim, _t0);
+    _arm(&sim, _t0 + 600);
+    _run(&sim, 10 * S);
+    _step_clock(&sim, (600 - 10 + ALARM_DEADLINE_GRACE_SEC - 1) * S);
+    _arm(&sim, _t0 + 600);
+    _run(&sim, 0);
+    CHECK_EQ(sim.fired, 1);
+
+    // further than that, it is skipped
+    _sim_init(&sim, _t0);
+    _arm(&sim, _t0 + 600);
+    _step_clock(&sim, (600 + ALARM_DEADLINE_GRACE_SEC) * S);
+    _arm(&sim, _t0 + 600);
+    _run(&sim, 3600 * S);
+    CHECK_EQ(sim.fired, 0);
+}
+
+// once it went off, neither setting the clock back, nor a resync that re-adds the
+// alarm, nor re-arming every minute brings it back
+static void
+test_once(void)
+{
+    sim_t sim;
+    _sim_init(&sim, _t0);
+    for (uint minute = 0; minute < 10; minute++) {
+        _arm(&sim, _t0 + 300);
+        _step_clock(&sim, 20000);  // the drift, corrected by each resync
+        _run(&sim, 60 * S);
+    }
+    CHECK_EQ(sim.fired, 1);
+
+    _step_clock(&sim, -600 * S);
+    _arm(&sim, _t0 + 300);
+    CHECK_EQ(sim.timer_us, -1);
+    _run(&sim, 3600 * S);
+    CHECK_EQ(sim.fired, 1);
+
+    // an older alarm that a resync brings in, is one that already passed
+    _arm(&sim, _t0 + 200);
+    CHECK_EQ(sim.timer_us, -1);
+
+    // the next one does go off
+    _arm(&sim, _t0 + 3600);
+    _run(&sim, 3600 * S);
+    CHECK_EQ(sim.fired, 2);
+}
+
+// The alarms are UTC, so DST doesn't move them: they go off after the time that really
+// passes, at the local time they were set for.  Across the fall back, the local hour
+// happens twice, but the alarm only once.
+static void
+test_dst(void)
+{
+    tz_t tz;
+    CHECK(tz_init(&tz, "CET-1CEST,M3.5.0,M10.5.0/3"));
+    struct {
+        time_t armed_at, alarm;  // UTC
+        int hour, min;           // local time of the alarm
+    } const cases[] = {
+        { 1679790600, 1679794200, 3, 30 },  // 2023-03-26 01:30 CET to 03:30 CEST, an hour apart
+        { 1698537600, 1698543000, 2, 30 },  // 2023-10-29 02:00 CEST to the second 02:30, in CET
+    };
+    for (uint ii = 0; ii < sizeof(cases) / sizeof(cases[0]); ii++) {
+        sim_t sim;
+        _sim_init(&sim, cases[ii].armed_at);
+        _arm(&sim, cases[ii].alarm);
+        _run(&sim, (cases[ii].alarm - cases[ii].armed_at) * S);
+        CHECK_EQ(sim.fired, 1);
+        struct tm tm;
+        tz_localtime(&tz, sim.fired_wall_us / S, &tm);
+        CHECK_EQ(tm.tm_hour, cases[ii].hour);
+        CHECK_EQ(tm.tm_min, cases[ii].min);
+        _run(&sim, 2 * 3600 * S);
+        CHECK_EQ(sim.fired, 1);
+    }
+}
+
+int
+main(void)
+{
+    TEST_RUN(test_on_time);
+    TEST_RUN(test_set_back);
+    TEST_RUN(test_set_forward);
+    TEST_RUN(test_once);
+    TEST_RUN(test_dst);
+    TEST_EXIT();
+}
@@ -0,0 +1,172 @@
+/**
+ * @brief test_ambient_light, replays ADC traces through the ambient light stage
+ *
+ * © Copyright 2016, 2022, Sander and Coert Vonk
+ *
+ * This file is part of CALalarm.
+ *
+ * CALalarm is free software: you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * CALalarm is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with CALalarm.
+ * If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ **/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ambient_light.h"
+#include "test.h"
+
+// The traces are one oversampled ADC reading per 10 seconds, the rate display_task
+// samples at.  They are synthesized here, with the noise of an oversampled reading
+// on top, except in the dark where the ADC reads 0; a trace logged from
+// _ambient_light_cb() replays the same way.
+
+#ifndef ARRAY_SIZE
+#define ARRAY_SIZE(a) (sizeof(a) / sizeof(*(a)))
+#endif
+
+#define SAMPLES_PER_HOUR (360)
+#define NOISE (24)  // peak, in ADC counts
+
+typedef struct replay_t {
+    uint writes;         // contrast changes handed to the panel
+    uint reversals;      // changes in the opposite direction of the one before
+    int contrast;        // last contrast handed to the panel
+    int last_write;      // sample index of the last change
+} replay_t;
+
+static uint32_t _seed;
+
+static int
+_noise(void)
+{
+    _seed = _seed * 1103515245 + 12345;
+    return (int)(_seed >> 16) % (2 * NOISE + 1) - NOISE;
+}
+
+static void
+_replay(int const * const trace, uint const len, replay_t * const r)
+{
+    ambient_light_t al;
+    ambient_light_init(&al);
+    memset(r, 0, sizeof(*r));
+    int direction = 0;
+    for (uint ii = 0; ii < len; ii++) {
+        int contrast;
+        if (ambient_light_update(&al, trace[ii], &contrast)) {
+            CHECK(contrast >= 0 && contrast <= 255);
+            if (r->writes) {
+                int const dir = contrast > r->contrast ? 1 : -1;
+                r->reversals += direction && dir != direction;
+                direction = dir;
+            }
+            r->writes++;
+            r->contrast = contrast;
+            r->last_write = ii;
+        }
+    }
+}
+
+static void
+test_lut(void)
+{
+    CHECK_EQ(ambient_light_adc2contrast(0), 0);
+    CHECK_EQ(ambient_light_adc2contrast(-5), 0);
+    CHECK(ambient_light_adc2contrast(4095) >= 250);
+    CHECK_EQ(ambient_light_adc2contrast(5000), ambient_light_adc2contrast(4095));
+    for (int adc = 1; adc <= 4095; adc++) {
+        CHECK(ambient_light_adc2contrast(adc) >= ambient_light_adc2contrast(adc - 1));
+    }
+}
+
+// a day in a lit room, just noise: only the first reading sets the contrast
+static void
+test_steady(void)
+{
+    static int trace[24 * SAMPLES_PER_HOUR];
+    _seed = 1;
+    for (uint ii = 0; ii < ARRAY_SIZE(trace); ii++) {
+        trace[ii] = 1500 + _noise();
+    }
+    replay_t r;
+    _replay(trace, ARRAY_SIZE(trace), &r);
+    CHECK_EQ(r.writes, 1);
+    CHECK_EQ(r.contrast, ambient_light_adc2contrast(1500));
+}
+
+// a lamp switched on in a dark room, and off again
+static void
+test_lamp(void)
+{
+    int trace[2 * SAMPLES_PER_HOUR];
+    _seed = 2;
+    for (uint ii = 0; ii < ARRAY_SIZE(trace); ii++) {
+        int const lit = ii >= 60 && ii < SAMPLES_PER_HOUR;
+        trace[ii] = lit ? 3000 + _noise() : 0;
+    }
+    replay_t r;
+    _replay(trace, 60 + 20, &r);  // on, within 200 s the contrast is close
+    CHECK(abs(r.contrast - ambient_light_adc2contrast(3000)) < 8);
+    _replay(trace, SAMPLES_PER_HOUR, &r);  // and then stays there
+    printf("  lamp on: %u writes\n", r.writes);
+    CHECK(r.writes <= 12);
+    CHECK_EQ(r.reversals, 0);
+    CHECK(abs(r.contrast - ambient_light_adc2contrast(3000)) < 8);
+
+    _replay(trace, ARRAY_SIZE(trace), &r);  // and off
+    CHECK(r.last_write - SAMPLES_PER_HOUR <= 20);
+    CHECK_EQ(r.contrast, 0);  // the dark end is not held back by the minimum step
+}
+
+// an hour long dusk: the contrast follows it down, without ever going back up
+static void
+test_dusk(void)
+{
+    int trace[2 * SAMPLES_PER_HOUR];
+    _seed = 3;
+    for (uint ii = 0; ii < ARRAY_SIZE(trace); ii++) {
+        int const level = ii < SAMPLES_PER_HOUR ? 3500 - 3500 * (int)ii / SAMPLES_PER_HOUR : 0;
+        trace[ii] = level > NOISE ? level + _noise() : 0;
+    }
+    replay_t r;
+    _replay(trace, ARRAY_SIZE(trace), &r);
+    printf("  dusk: %u writes in an hour\n", r.writes);
+    CHECK_EQ(r.reversals, 0);
+    CHECK(r.writes <= 60);
+    CHECK_EQ(r.contrast, 0);
+}
+
+// single outliers, like a passing headlight, don't reach the panel
+static void
+test_outliers(void)
+{
+    int trace[SAMPLES_PER_HOUR];
+    _seed = 4;
+    for (uint ii = 0; ii < ARRAY_SIZE(trace); ii++) {
+        trace[ii] = (ii % 30 == 15 ? 4095 : 800) + _noise();
+    }
+    replay_t r;
+    _replay(trace, ARRAY_SIZE(trace), &r);
+    CHECK_EQ(r.writes, 1);
+}
+
+int
+main(void)
+{
+    TEST_RUN(test_lut);
+    TEST_RUN(test_steady);
+    TEST_RUN(test_lamp);
+    TEST_RUN(test_dusk);
+    TEST_RUN(test_outliers);
+    TEST_EXIT();
+}
@@ -0,0 +1,695 @@
+/**
+ * @brief test_calendar_json, the streaming parser for the calendar payload
+ *
+ * © Copyright 2016, 2022, Sander and Coert Vonk
+ *
+ * This file is part of CALalarm.
+ *
+ * CALalarm is free software: you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * CALalarm is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with CALalarm.
+ * If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ **/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <dirent.h>
+#include <malloc.h>
+
+#include "calendar_json.h"
+#include "tz.h"
+#include "test.h"
+#ifdef HAVE_CJSON
+# include "cJSON.h"
+#endif
+
+// Local time stamps are checked against strptime() and mktime() in the same TZ.
+
+#define ZONE "PST8PDT,M3.2.0,M11.1.0"
+
+static char const _payload[] =
+    "{ \"time\": \"2022-04-20 13:18:37\",\n"
+    "  \"pushId\": \"abc-123\",\n"
+    "  \"hash\": \"5d41402abc4b2a76\",\n"
+    "  \"events\": [\n"
+    "    { \"title\": \"Dentist\", \"alarm\": \"2022-04-20 14:50:00\", \"start\": \"2022-04-20 15:00:00\", \"stop\": \"2022-04-20 16:00:00\" },\n"
+    "    { \"alarm\": \"2022-04-21 08:45:00\", \"stop\": \"2022-04-21 10:00:00\", \"start\": \"2022-04-21 09:00:00\", \"title\": \"Caf\\u00e9 \\\"Ole\\\"\\n\", \"id\": 17 },\n"
+    "    { \"title\": \"No alarm\", \"start\": \"2022-04-21 11:00:00\", \"stop\": \"2022-04-21 12:00:00\" }\n"
+    "  ],\n"
+    "  \"extra\": { \"title\": \"not an event\", \"list\": [1, -2.5e3, true, false, null, {\"a\": []}] }\n"
+    "}\n";
+
+static time_t
+_reference(char const * const str)
+{
+    struct tm tm = { .tm_isdst = -1 };
+    CHECK(strptime(str, "%Y-%m-%d %H:%M:%S", &tm) != NULL);
+    tm.tm_isdst = -1;
+    return mktime(&tm);
+}
+
+static void
+_feed(calendar_json_payload_t * const payload, tz_t * const tz, char const * const json, size_t const len, size_t const chunk)
+{
+    calendar_json_payload_init(payload, tz);
+    for (size_t ii = 0; ii < len; ii += chunk) {
+        calendar_json_feed(&payload->json, json + ii, ii + chunk < len ? chunk : len - ii);
+    }
+}
+
+static void
+_parse(calendar_json_payload_t * const payload, tz_t * const tz, char const * const json, size_t const chunk)
+{
+    _feed(payload, tz, json, strlen(json), chunk);
+}
+
+static calendar_json_status_t
+_status(char const * const json)
+{
+    static calendar_json_payload_t payload;
+    _parse(&payload, NULL, json, strlen(json) ? strlen(json) : 1);
+    return calendar_json_status(&payload.json);
+}
+
+static void
+_check_payload(calendar_json_t const * const json)
+{
+    CHECK_EQ(calendar_json_status(json), CALENDAR_JSON_DONE);
+    CHECK_EQ(json->time, _reference("2022-04-20 13:18:37"));
+    CHECK(json->pushId && strcmp(json->pushId, "abc-123") == 0);
+    CHECK(json->hash && strcmp(json->hash, "5d41402abc4b2a76") == 0);
+    CHECK_EQ(json->events_len, 2);
+    CHECK_EQ(json->events_dropped, 1);  // no alarm
+    if (json->events_len == 2) {
+        CHECK(strcmp(json->events[0].title, "Dentist") == 0);
+        CHECK_EQ(json->events[0].alarm, _reference("2022-04-20 14:50:00"));
+        CHECK_EQ(json->events[0].start, _reference("2022-04-20 15:00:00"));
+        CHECK_EQ(json->events[0].stop, _reference("2022-04-20 16:00:00"));
+        CHECK(strcmp(json->events[1].title, "Caf\xC3\xA9 \"Ole\"\n") == 0);
+        CHECK_EQ(json->events[1].start, _reference("2022-04-21 09:00:00"));
+    }
+}
+
+static void
+test_payload(void)
+{
+    static calendar_json_payload_t payload;
+    tz_t tz;
+    tz_init(&tz, ZONE);
+    _parse(&payload, &tz, _payload, sizeof(_payload));
+    _check_payload(&payload.json);
+
+    // mktime() instead of the compiled rule gives the same
+    _parse(&payload, NULL, _payload, sizeof(_payload));
+    _check_payload(&payload.json);
+}
+
+// however the body is split up as it arrives
+static void
+test_chunks(void)
+{
+    static calendar_json_payload_t payload;
+    tz_t tz;
+    tz_init(&tz, ZONE);
+    for (size_t chunk = 1; chunk < sizeof(_payload); chunk++) {
+        _parse(&payload, &tz, _payload, chunk);
+        int const before = test_failures;
+        _check_payload(&payload.json);
+        if (test_failures != before) {
+            fprintf(stderr, "in chunks of %zu\n", chunk);
+            return;
+        }
+    }
+}
+
+static void
+test_unicode(void)
+{
+    static calendar_json_payload_t payload;
+    char const * const json =
+        "{\"events\":[{\"alarm\":\"2022-04-20 14:50:00\",\"start\":\"2022-04-20 15:00:00\",\"stop\":\"2022-04-20 16:00:00\","
+        "\"title\":\"\\ud83d\\ude00 \\ud83d x \\ude00 \\u20AC\\/\\t\\\\ \xC3\xA9\"}]}";
+    _parse(&payload, NULL, json, strlen(json));
+    CHECK_EQ(calendar_json_status(&payload.json), CALENDAR_JSON_DONE);
+    CHECK_EQ(payload.json.events_len, 1);
+    if (payload.json.events_len == 1) {
+        // a surrogate pair, a lone high and a lone low surrogate, and a raw UTF-8 byte sequence
+        CHECK(strcmp(payload.json.events[0].title,
+                     "\xF0\x9F\x98\x80 \xEF\xBF\xBD x \xEF\xBF\xBD \xE2\x82\xAC/\t\\ \xC3\xA9") == 0);
+    }
+}
+
+// events that don't fit the records, or whose title doesn't fit the arena, are dropped
+static void
+test_limits(void)
+{
+    char * const json = malloc(64 * 1024);
+    size_t len = sprintf(json, "{\"events\":[");
+    for (uint ii = 0; ii < CALENDAR_JSON_EVENTS_MAX + 3; ii++) {
+        len += sprintf(json + len, "%s{\"alarm\":\"2022-04-20 14:50:00\",\"start\":\"2022-04-20 15:00:00\","
+                       "\"stop\":\"2022-04-20 16:00:00\",\"title\":\"event %u\"}", ii ? "," : "", ii);
+    }
+    sprintf(json + len, "]}");
+
+    static calendar_json_payload_t payload;
+    _parse(&payload, NULL, json, 100);
+    CHECK_EQ(calendar_json_status(&payload.json), CALENDAR_JSON_DONE);
+    CHECK_EQ(payload.json.events_len, CALENDAR_JSON_EVENTS_MAX);
+    CHECK_EQ(payload.json.events_dropped, 3);
+    CHECK(strcmp(payload.json.events[CALENDAR_JSON_EVENTS_MAX - 1].title, "event 31") == 0);
+
+    // a title longer than the arena, the next event still fits
+    len = sprintf(json, "{\"events\":[{\"alarm\":\"2022-04-20 14:50:00\",\"start\":\"2022-04-20 15:00:00\","
+                  "\"stop\":\"2022-04-20 16:00:00\",\"title\":\"");
+    memset(json + len, 'x', CALENDAR_JSON_ARENA_SIZE);
+    len += CALENDAR_JSON_ARENA_SIZE;
+    sprintf(json + len, "\"},{\"alarm\":\"2022-04-20 14:50:00\",\"start\":\"2022-04-20 15:00:00\","
+            "\"stop\":\"2022-04-20 16:00:00\",\"title\":\"short\"}]}");
+    _parse(&payload, NULL, json, 64);
+    CHECK_EQ(calendar_json_status(&payload.json), CALENDAR_JSON_DONE);
+    CHECK_EQ(payload.json.events_len, 1);
+    CHECK_EQ(payload.json.events_dropped, 1);
+    CHECK(payload.json.events_len == 1 && strcmp(payload.json.events[0].title, "short") == 0);
+    free(json);
+}
+
+static void
+test_errors(void)
+{
+    CHECK_EQ(_status("{}"), CALENDAR_JSON_DONE);
+    CHECK_EQ(_status(" {\"a\" : [ ] } \r\n"), CALENDAR_JSON_DONE);
+    CHECK_EQ(_status("{\"a\": 1"), CALENDAR_JSON_MORE);
+    CHECK_EQ(_status("[1]"), CALENDAR_JSON_ERROR);
+    CHECK_EQ(_status("\"str\""), CALENDAR_JSON_ERROR);
+    CHECK_EQ(_status("{\"a\": [}"), CALENDAR_JSON_ERROR);
+    CHECK_EQ(_status("{\"a\": 1,}"), CALENDAR_JSON_ERROR);
+    CHECK_EQ(_status("{\"a\" 1}"), CALENDAR_JSON_ERROR);
+    CHECK_EQ(_status("{\"a\": \"x\ny\"}"), CALENDAR_JSON_ERROR);
+    CHECK_EQ(_status("{\"a\": \"\\x\"}"), CALENDAR_JSON_ERROR);
+    CHECK_EQ(_status("{\"a\": \"\\u12G4\"}"), CALENDAR_JSON_ERROR);
+    CHECK_EQ(_status("{} x"), CALENDAR_JSON_ERROR);
+    CHECK_EQ(_status("{\"a\":[[[[[[[[1]]]]]]]]}"), CALENDAR_JSON_ERROR);  // too deep
+    CHECK_EQ(_status("{\"a\":[[[[[[1]]]]]]}"), CALENDAR_JSON_DONE);
+}
+
+static time_t
+_time(char const * const str, tz_t * const tz)
+{
+    static calendar_json_payload_t payload;
+    char json[64];
+    snprintf(json, sizeof(json), "{\"time\":\"%s\"}", str);
+    _parse(&payload, tz, json, strlen(json));
+    return payload.json.time;
+}
+
+// Every 37 minutes for two years, so across the DST edges, then the odd ones.
+static void
+test_time_stamps(void)
+{
+    tz_t tz;
+    tz_init(&tz, ZONE);
+    for (time_t t = 1640995200; t < 1704067200; t += 37 * 60) {
+        struct tm tm;
+        localtime_r(&t, &tm);
+        char str[24];
+        strftime(str, sizeof(str), "%Y-%m-%d %H:%M:%S", &tm);
+        // in the hour that repeats, either one will do, as long as it formats back the same
+        time_t const times[2] = { _time(str, &tz), _time(str, NULL) };
+        for (uint ii = 0; ii < 2; ii++) {
+            struct tm back;
+            char str_back[24];
+            strftime(str_back, sizeof(str_back), "%Y-%m-%d %H:%M:%S", localtime_r(&times[ii], &back));
+            if (strcmp(str, str_back) != 0) {
+                fprintf(stderr, "%s: came back as %s\n", str, str_back);
+                test_failures++;
+                return;
+            }
+        }
+    }
+    // in the hour that is skipped, and out of range, normalized like mktime()
+    char const * const edges[] = { "2022-03-13 02:30:00", "2022-04-31 10:00:00", "2022-12-31 23:59:60" };
+    for (uint ii = 0; ii < sizeof(edges) / sizeof(edges[0]); ii++) {
+        CHECK_EQ(_time(edges[ii], &tz), _reference(edges[ii]));
+        CHECK_EQ(_time(edges[ii], NULL), _reference(edges[ii]));
+    }
+    char const * const bad[] = { "2022-04-20", "2022-04-20T13:18:37", "2022-13-01 00:00:00", "2022-04-20 24:00:00", "2022-04-2x 10:00:00", "" };
+    for (uint ii = 0; ii < sizeof(bad) / sizeof(bad[0]); ii++) {
+        CHECK_EQ(_time(bad[ii], &tz), 0);
+    }
+}
+
+// Each file in corpus/calendar_json, and mutants of it, must give the same result
+// whether it arrives in one go or byte by byte, and must leave the records and the
+// arena consistent.  fuzz_calendar_json.c starts libFuzzer from the same corpus.
+
+static bool
+_same_str(char const * const a, char const * const b)
+{
+    return a == b || (a && b && strcmp(a, b) == 0);
+}
+
+static bool
+_same(calendar_json_t const * const a, calendar_json_t const * const b)
+{
+    if (calendar_json_status(a) != calendar_json_status(b) || a->time != b->time ||
+        a->events_len != b->events_len || a->events_dropped != b->events_dropped ||
+        !_same_str(a->pushId, b->pushId) || !_same_str(a->hash, b->hash)) {
+        return false;
+    }
+    for (uint ii = 0; ii < a->events_len; ii++) {
+        calendar_json_event_t const * const ea = &a->events[ii];
+        calendar_json_event_t const * const eb = &b->events[ii];
+        if (ea->alarm != eb->alarm || ea->start != eb->start || ea->stop != eb->stop ||
+            !_same_str(ea->title, eb->title)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// a string that starts in the arena, and ends there
+static bool
+_in_arena(calendar_json_t const * const json, char const * const str)
+{
+    return !str || (str >= json->arena && str < json->arena + json->arena_len &&
+                    memchr(str, '\0', json->arena + json->arena_len - str));
+}
+
+static bool
+_sane(calendar_json_t const * const json)
+{
+    if (json->events_len > json->events_max || json->arena_len > json->arena_size ||
+        !_in_arena(json, json->pushId) || !_in_arena(json, json->hash)) {
+        return false;
+    }
+    for (uint ii = 0; ii < json->events_len; ii++) {
+        if (!json->events[ii].title || !_in_arena(json, json->events[ii].title)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static uint32_t
+_random(uint32_t * const seed)
+{
+    *seed = *seed * 1103515245 + 12345;
+    return *seed >> 8;
+}
+
+// flip, insert, delete or repeat a few bytes, or cut it short
+static size_t
+_mutate(char * const buf, size_t len, size_t const size, uint32_t * const seed)
+{
+    static char const tokens[] = "{}[]\":,\\u0123456789abcdefABCDEF -+.eEtrufalsn\n\x80\xC3\xED\xF0";
+    uint const edits = 1 + _random(seed) % 4;
+    for (uint ee = 0; ee < edits && len; ee++) {
+        size_t const at = _random(seed) % len;
+        char const c = _random(seed) % 4 ? tokens[_random(seed) % (sizeof(tokens) - 1)] : (char)_random(seed);
+        switch (_random(seed) % 5) {
+            case 0:
+                buf[at] = c;
+                break;
+            case 1:
+                if (len < size) {
+                    memmove(buf + at + 1, buf + at, len - at);
+                    buf[at] = c;
+                    len++;
+                }
+                break;
+            case 2:
+                memmove(buf + at, buf + at + 1, len - at - 1);
+                len--;
+                break;
+            case 3: {
+                size_t const n = _random(seed) % 16;
+                if (len + n <= size && at + n <= len) {
+                    memmove(buf + at + n, buf + at, len - at);
+                    len += n;
+                }
+                break;
+            }
+            default:
+                len = at;
+        }
+    }
+    return len;
+}
+
+#define CORPUS_MUTANTS (2000)
+
+static void
+test_corpus(void)
+{
+    static calendar_json_payload_t whole, bytes;
+    static char seed_buf[8192], buf[8192];
+    tz_t tz;
+    tz_init(&tz, ZONE);
+
+    DIR * const dir = opendir(CORPUS_DIR);
+    CHECK(dir);
+    if (!dir) {
+        return;
+    }
+    uint files = 0, done = 0, mutants = 0;
+    struct dirent const * entry;
+    while ((entry = readdir(dir))) {
+        if (entry->d_name[0] == '.') {
+            continue;
+        }
+        char path[512];
+        snprintf(path, sizeof(path), "%s/%s", CORPUS_DIR, entry->d_name);
+        FILE * const f = fopen(path, "rb");
+        CHECK(f);
+        if (!f) {
+            continue;
+        }
+        size_t const seed_len = fread(seed_buf, 1, sizeof(seed_buf), f);
+        fclose(f);
+        files++;
+
+        // the seeds themselves are valid
+        _feed(&whole, &tz, seed_buf, seed_len, seed_len);
+        CHECK_EQ(calendar_json_status(&whole.json), CALENDAR_JSON_DONE);
+
+        uint32_t seed = files;
+        for (uint mm = 0; mm < CORPUS_MUTANTS; mm++) {
+            memcpy(buf, seed_buf, seed_len);
+            size_t const len = _mutate(buf, seed_len, sizeof(buf), &seed);
+            _feed(&whole, &tz, buf, len, len ? len : 1);
+            _feed(&bytes, &tz, buf, len, 1);
+            mutants++;
+            done += calendar_json_status(&whole.json) == CALENDAR_JSON_DONE;
+            if (!_sane(&whole.json) || !_same(&whole.json, &bytes.json)) {
+                fprintf(stderr, "%s, mutant %u: \"%.*s\"\n", entry->d_name, mm, (int)len, buf);
+                test_failures++;
+                break;
+            }
+        }
+    }
+    closedir(dir);
+    CHECK(files >= 5);
+    printf("  %u seeds, %u mutants, %u of them still complete\n", files, mutants, done);
+}
+
+// Heap in use, for the peak during a parse.  The test is linked with --wrap for these,
+// so they count the calls from calendar_json.c and cJSON.c alike.
+
+void * __real_malloc(size_t size);
+void * __real_calloc(size_t nmemb, size_t size);
+void * __real_realloc(void * ptr, size_t size);
+void __real_free(void * ptr);
+
+static size_t _heap, _heap_peak;
+
+static void
+_heap_add(void * const ptr)
+{
+    if (ptr) {
+        _heap += malloc_usable_size(ptr);
+        if (_heap > _heap_peak) {
+            _heap_peak = _heap;
+        }
+    }
+}
+
+void *
+__wrap_malloc(size_t const size)
+{
+    void * const ptr = __real_malloc(size);
+    _heap_add(ptr);
+    return ptr;
+}
+
+void *
+__wrap_calloc(size_t const nmemb, size_t const size)
+{
+    void * const ptr = __real_calloc(nmemb, size);
+    _heap_add(ptr);
+    return ptr;
+}
+
+void *
+__wrap_realloc(void * const ptr, size_t const size)
+{
+    size_t const before = ptr ? malloc_usable_size(ptr) : 0;
+    void * const moved = __real_realloc(ptr, size);
+    if (moved || !size) {
+        _heap -= before;
+        _heap_add(moved);
+    }
+    return moved;
+}
+
+void
+__wrap_free(void * const ptr)
+{
+    if (ptr) {
+        _heap -= malloc_usable_size(ptr);
+    }
+    __real_free(ptr);
+}
+
+// a payload the way the server sends it
+static size_t
+_events_json(char * const json, uint const n)
+{
+    size_t len = sprintf(json, "{\"time\":\"2022-04-20 13:18:37\",\"pushId\":\"-N1x8aQp0bT3rZ6yW2kL\",\"events\":[");
+    for (uint ii = 0; ii < n; ii++) {
+        uint const day = 1 + ii % 28;
+        len += sprintf(json + len, "%s{\"title\":\"Meeting %u\",\"alarm\":\"2022-05-%02u 08:50:00\","
+                       "\"start\":\"2022-05-%02u 09:00:00\",\"stop\":\"2022-05-%02u 10:00:00\"}",
+                       ii ? "," : "", ii, day, day, day);
+    }
+    len += sprintf(json + len, "]}");
+    return len;
+}
+
+#define BENCH_EVENTS (100)
+
+static uint
+_streaming(tz_t * const tz, char const * const json, size_t const len)
+{
+    static calendar_json_event_t events[BENCH_EVENTS];
+    static char arena[BENCH_EVENTS * 16 + 64];
+    calendar_json_t p;
+    calendar_json_init(&p, events, BENCH_EVENTS, arena, sizeof(arena), tz);
+    calendar_json_feed(&p, json, len);
+    return calendar_json_status(&p) == CALENDAR_JSON_DONE ? p.events_len : 0;
+}
+
+#ifdef HAVE_CJSON
+
+static time_t
+_str2time(char const * const str)
+{
+    struct tm tm;
+    if (strptime(str, "%Y-%m-%d %H:%M:%S", &tm) == NULL) {
+        return 0;
+    }
+    return mktime(&tm);
+}
+
+// what the display task and the https client did before: each parsed the payload into
+// a cJSON tree, one for the events, the other for pushId
+static uint
+_cjson(char const * const json)
+{
+    uint len = 0;
+    cJSON * const root = cJSON_Parse(json);
+    if (root) {
+        cJSON const * const time = cJSON_GetObjectItem(root, "time");
+        if (time && time->type == cJSON_String) {
+            _str2time(time->valuestring);
+        }
+        cJSON const * const jsonEvents = cJSON_GetObjectItem(root, "events");
+        cJSON const * event;
+        cJSON_ArrayForEach(event, jsonEvents) {
+            cJSON const * const title = cJSON_GetObjectItem(event, "title");
+            cJSON const * const alarm = cJSON_GetObjectItem(event, "alarm");
+            cJSON const * const start = cJSON_GetObjectItem(event, "start");
+            cJSON const * const stop = cJSON_GetObjectItem(event, "stop");
+            if (title && alarm && start && stop && _str2time(alarm->valuestring) &&
+                _str2time(start->valuestring) && _str2time(stop->valuestring)) {
+                len++;
+            }
+        }
+        cJSON_Delete(root);
+    }
+    cJSON * const root2 = cJSON_Parse(json);
+    if (root2) {
+        cJSON_GetObjectItem(root2, "pushId");
+        cJSON_Delete(root2);
+    }
+    return len;
+}
+
+#endif
+
+static void
+test_bench(void)
+{
+    tz_t tz;
+    tz_init(&tz, ZONE);
+    static char json[BENCH_EVENTS * 160 + 128];
+    uint const counts[] = { 1, 10, BENCH_EVENTS };
+    for (uint ii = 0; ii < sizeof(counts) / sizeof(counts[0]); ii++) {
+        uint const n = counts[ii];
+        size_t const len = _events_json(json, n);
+        uint const rounds = 20000 / n;
+
+        _heap_peak = _heap;
+        size_t const before = _heap;
+        CHECK_EQ(_streaming(&tz, json, len), n);
+        size_t const streaming_heap = _heap_peak - before;
+        CHECK_EQ(streaming_heap, 0);
+        uint64_t const start = test_ns();
+        for (uint rr = 0; rr < rounds; rr++) {
+            _streaming(&tz, json, len);
+        }
+        uint64_t const streaming_ns = (test_ns() - start) / rounds;
+        printf("  %3u events, %5zu bytes: streaming %7llu ns, %5zu bytes heap\n",
+               n, len, (unsigned long long)streaming_ns, streaming_heap);
+#ifdef HAVE_CJSON
+        _heap_peak = _heap;
+        CHECK_EQ(_cjson(json), n);
+        size_t const cjson_heap = _heap_peak - before;
+        uint64_t const cjson_start = test_ns();
+        for (uint rr = 0; rr < rounds; rr++) {
+            _cjson(json);
+        }
+        uint64_t const cjson_ns = (test_ns() - cjson_start) / rounds;
+        printf("  %3u events, %5zu bytes: cJSON     %7llu ns, %5zu bytes heap\n",
+               n, len, (unsigned long long)cjson_ns, cjson_heap);
+#endif
+    }
+    printf("  streaming uses a %zu byte calendar_json_payload_t instead\n", sizeof(calendar_json_payload_t));
+}
+
+// The time stamps alone: a payload of 64 of them over 3 days, less the same payload with
+// the keys renamed so they are skipped, against strptime() and mktime() as _str2time()
+// did before.  Over ordinary days, and over the weekend DST ends, where mktime() still
+// runs for every time stamp on the Sunday.
+#define BENCH_STAMPS (64)
+
+static size_t
+_stamps_json(char * const json, char const * const days[3], char const * const keys[4])
+{
+    size_t len = sprintf(json, "{\"%s\":\"%s 06:00:00\",\"events\":[", keys[0], days[0]);
+    for (uint ii = 0; ii < (BENCH_STAMPS - 1) / 3; ii++) {
+        char const * const day = days[ii * 3 / ((BENCH_STAMPS - 1) / 3)];
+        uint const hour = 6 + ii % 12;
+        len += sprintf(json + len, "%s{\"title\":\"e\",\"%s\":\"%s %02u:50:00\",\"%s\":\"%s %02u:00:00\",\"%s\":\"%s %02u:30:00\"}",
+                       ii ? "," : "", keys[1], day, hour - 1, keys[2], day, hour, keys[3], day, hour);
+    }
+    len += sprintf(json + len, "]}");
+    return len;
+}
+
+// fastest of a few runs, the others were interrupted
+static uint64_t
+_parse_ns(tz_t * const tz, char const * const json, size_t const len)
+{
+    static calendar_json_payload_t payload;
+    uint64_t best = UINT64_MAX;
+    for (uint run = 0; run < 5; run++) {
+        uint64_t const start = test_ns();
+        for (uint rr = 0; rr < 1000; rr++) {
+            _feed(&payload, tz, json, len, len);
+        }
+        uint64_t const ns = (test_ns() - start) / 1000;
+        best = ns < best ? ns : best;
+    }
+    return best;
+}
+
+static uint64_t
+_libc_ns(char const stamps[][CALENDAR_JSON_TIME_LEN])
+{
+    uint64_t best = UINT64_MAX;
+    for (uint run = 0; run < 5; run++) {
+        uint64_t const start = test_ns();
+        for (uint rr = 0; rr < 1000; rr++) {
+            for (uint ii = 0; ii < BENCH_STAMPS; ii++) {
+                struct tm tm = { .tm_isdst = -1 };
+                strptime(stamps[ii], "%Y-%m-%d %H:%M:%S", &tm);
+                mktime(&tm);
+            }
+        }
+        uint64_t const ns = (test_ns() - start) / 1000;
+        best = ns < best ? ns : best;
+    }
+    return best;
+}
+
+static void
+test_bench_time(void)
+{
+    tz_t tz;
+    tz_init(&tz, ZONE);
+    static char const * const weeks[][3] = {
+        { "2022-04-19", "2022-04-20", "2022-04-21" },
+        { "2022-11-05", "2022-11-06", "2022-11-07" },
+    };
+    for (uint ww = 0; ww < sizeof(weeks) / sizeof(weeks[0]); ww++) {
+        static char json[BENCH_STAMPS * 40 + 128], skipped[BENCH_STAMPS * 40 + 128];
+        size_t const len = _stamps_json(json, weeks[ww], (char const *[4]) { "time", "alarm", "start", "stop" });
+        size_t const skipped_len = _stamps_json(skipped, weeks[ww], (char const *[4]) { "xime", "xlarm", "xtart", "xtop" });
+        CHECK_EQ(len, skipped_len);
+
+        // the same times as the libc path gives
+        char stamps[BENCH_STAMPS][CALENDAR_JSON_TIME_LEN];
+        uint stamps_len = 0;
+        for (char const * at = json; (at = strstr(at, "\":\"20")); at += 3) {
+            memcpy(stamps[stamps_len], at + 3, 19);
+            stamps[stamps_len++][19] = '\0';
+        }
+        CHECK_EQ(stamps_len, BENCH_STAMPS);
+        static calendar_json_payload_t payload;
+        _feed(&payload, &tz, json, len, len);
+        CHECK_EQ(payload.json.events_len, (BENCH_STAMPS - 1) / 3);
+        CHECK_EQ(payload.json.time, _reference(stamps[0]));
+        for (uint ii = 0; ii < payload.json.events_len; ii++) {
+            CHECK_EQ(payload.json.events[ii].alarm, _reference(stamps[1 + ii * 3]));
+            CHECK_EQ(payload.json.events[ii].start, _reference(stamps[2 + ii * 3]));
+            CHECK_EQ(payload.json.events[ii].stop, _reference(stamps[3 + ii * 3]));
+        }
+
+        int64_t const skipped_ns = _parse_ns(&tz, skipped, skipped_len);
+        int64_t const tz_ns = _parse_ns(&tz, json, len);
+        int64_t const mktime_ns = _parse_ns(NULL, json, len);
+        uint64_t const libc_ns = _libc_ns((char const (*)[CALENDAR_JSON_TIME_LEN])stamps);
+        printf("  %s..%s, per time stamp: %4lld ns with the zone rule, %4lld ns with mktime() once a day, "
+               "%4llu ns with strptime() and mktime()\n", weeks[ww][0], weeks[ww][2] + 8,
+               (long long)(tz_ns - skipped_ns) / BENCH_STAMPS, (long long)(mktime_ns - skipped_ns) / BENCH_STAMPS,
+               (unsigned long long)libc_ns / BENCH_STAMPS);
+    }
+}
+
+int
+main(void)
+{
+    setenv("TZ", ZONE, 1);
+    tzset();
+
+    TEST_RUN(test_payload);
+    TEST_RUN(test_chunks);
+    TEST_RUN(test_unicode);
+    TEST_RUN(test_limits);
+    TEST_RUN(test_errors);
+    TEST_RUN(test_time_stamps);
+    TEST_RUN(test_corpus);
+    TEST_RUN(test_bench);
+    TEST_RUN(test_bench_time);
+    TEST_EXIT();
+}
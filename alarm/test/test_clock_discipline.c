@@ -0,0 +1,179 @@
+/**
+ * @brief test_clock_discipline, wall clock corrections from the time stamps of the calendar script
+ *
+ * © Copyright 2016, 2022, Sander and Coert Vonk
+ *
+ * This file is part of CALalarm.
+ *
+ * CALalarm is free software: you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * CALalarm is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with CALalarm.
+ * If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ **/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "clock_discipline.h"
+#include "test.h"
+
+static int64_t const _t0_us = 1700000000LL * 1000000;  // true time when the simulation starts
+
+static void
+test_first_sync_steps(void)
+{
+    clock_discipline_t cd;
+    clock_discipline_init(&cd);
+    CHECK_EQ(clock_discipline_tick(&cd, 5000000), 0);  // nothing before the first sync
+
+    // stamped 1700000100 s, round trip of 200 ms, that ended at wall 1700000000.3 s
+    clock_discipline_sample_t const sample = {
+        .server = 1700000100,
+        .send_us = 1000000,
+        .recv_us = 1200000,
+        .wall_us = 1700000000300000LL,
+    };
+    bool step;
+    int64_t const correction = clock_discipline_sync(&cd, &sample, &step);
+    CHECK(step);
+    // midpoint at wall ..000.2 s, best estimate ..100.5 s
+    CHECK_EQ(correction, 100300000);
+    CHECK_EQ(cd.rtt_us, 200000);
+}
+
+static void
+test_slew_and_step(void)
+{
+    clock_discipline_t cd;
+    clock_discipline_init(&cd);
+    bool step;
+    clock_discipline_sample_t sample = {
+        .server = 1700000000, .send_us = 0, .recv_us = 0, .wall_us = 1700000000500000LL,
+    };
+    clock_discipline_sync(&cd, &sample, &step);
+
+    // 2 s behind is slewed, half at a time
+    sample = (clock_discipline_sample_t) {
+        .server = 1700000602, .send_us = 600000000, .recv_us = 600000000, .wall_us = 1700000600500000LL,
+    };
+    CHECK_EQ(clock_discipline_sync(&cd, &sample, &step), 1000000);
+    CHECK(!step);
+
+    // more than a minute off is stepped
+    sample = (clock_discipline_sample_t) {
+        .server = 1700001300, .send_us = 1200000000, .recv_us = 1200000000, .wall_us = 1700001200500000LL,
+    };
+    CHECK_EQ(clock_discipline_sync(&cd, &sample, &step), 100000000);
+    CHECK(step);
+}
+
+// an offset that would mean an impossible drift is clamped
+static void
+test_drift_clamp(void)
+{
+    clock_discipline_t cd;
+    clock_discipline_init(&cd);
+    bool step;
+    clock_discipline_sample_t sample = {
+        .server = 1700000000, .send_us = 0, .recv_us = 0, .wall_us = 1700000000500000LL,
+    };
+    clock_discipline_sync(&cd, &sample, &step);
+
+    int64_t const later_us = CLOCK_DISCIPLINE_BASELINE_US;
+    sample = (clock_discipline_sample_t) {
+        .server = 1700000000 + later_us / 1000000 + 59,
+        .send_us = later_us, .recv_us = later_us,
+        .wall_us = 1700000000500000LL + later_us,
+    };
+    clock_discipline_sync(&cd, &sample, &step);
+    CHECK(!step);
+    CHECK_EQ(cd.drift_ppb, CLOCK_DISCIPLINE_DRIFT_MAX_PPB);
+}
+
+// the drift is handed out in whole microseconds, without losing the remainder
+static void
+test_tick(void)
+{
+    clock_discipline_t cd;
+    clock_discipline_init(&cd);
+    bool step;
+    clock_discipline_sample_t const sample = {
+        .server = 1700000000, .send_us = 0, .recv_us = 0, .wall_us = 1700000000500000LL,
+    };
+    clock_discipline_sync(&cd, &sample, &step);
+    cd.drift_ppb = 12345;
+
+    int64_t sum = 0;
+    for (int64_t now_us = 0; now_us <= 1000LL * 1000000; now_us += 333333) {
+        sum += clock_discipline_tick(&cd, now_us);
+    }
+    int64_t const expected = 12345LL * (1000LL * 1000000 / 333333 * 333333) / 1000000000;
+    CHECK(sum == expected || sum == expected - 1);
+    CHECK_EQ(clock_discipline_tick(&cd, 0), 0);  // going back in time
+}
+
+// A wall clock that runs 40 ppm slow, synced every 12 minutes over a link with a
+// round trip of 50 to 800 ms.  The server stamps the response at a random moment
+// during the round trip, truncated to the second.  Each time stamp is off by up to
+// 0.5 s, plus half the round trip, so that is how close the clock can stay.
+static void
+test_simulation(void)
+{
+    int32_t const slow_ppb = 40000;
+    int64_t const interval_us = 12 * 60 * 1000000LL;
+    int64_t const tick_us = 10 * 1000000LL;
+
+    clock_discipline_t cd;
+    clock_discipline_init(&cd);
+    srand(1);
+
+    int64_t wall_offset_us = -3600LL * 1000000;  // wall minus true time, an hour behind at boot
+    int64_t next_sync_us = 0;
+    int64_t worst_us = 0;
+    for (int64_t mono_us = 0; mono_us < 48 * 3600 * 1000000LL; mono_us += tick_us) {
+        wall_offset_us -= tick_us * slow_ppb / 1000000000;
+        wall_offset_us += clock_discipline_tick(&cd, mono_us);
+
+        if (mono_us >= next_sync_us) {
+            int64_t const rtt_us = 50000 + rand() % 750000;
+            int64_t const stamp_us = _t0_us + mono_us + rand() % rtt_us;
+            clock_discipline_sample_t const sample = {
+                .server = stamp_us / 1000000,
+                .send_us = mono_us,
+                .recv_us = mono_us + rtt_us,
+                .wall_us = _t0_us + mono_us + rtt_us + wall_offset_us,
+            };
+            bool step;
+            wall_offset_us += clock_discipline_sync(&cd, &sample, &step);
+            CHECK(step == (next_sync_us == 0));
+            next_sync_us += interval_us;
+        }
+        if (mono_us > 3600 * 1000000LL) {
+            int64_t const err_us = llabs(wall_offset_us);
+            if (err_us > worst_us) worst_us = err_us;
+        }
+    }
+    printf("  drift estimate %d ppb for %d ppb, worst offset %lld ms\n", cd.drift_ppb, slow_ppb, (long long)worst_us / 1000);
+    CHECK(llabs(cd.drift_ppb - slow_ppb) < 10000);
+    CHECK(worst_us < 1000000);
+}
+
+int
+main(void)
+{
+    TEST_RUN(test_first_sync_steps);
+    TEST_RUN(test_slew_and_step);
+    TEST_RUN(test_drift_clamp);
+    TEST_RUN(test_tick);
+    TEST_RUN(test_simulation);
+    TEST_EXIT();
+}
@@ -0,0 +1,149 @@
+/**
+ * @brief test_font24x24_clock, the precomputed clock glyphs against the 3x scaling kernel
+ *
+ * © Copyright 2016, 2022, Sander and Coert Vonk
+ *
+ * This file is part of CALalarm.
+ *
+ * CALalarm is free software: you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * CALalarm is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with CALalarm.
+ * If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ **/
+
+#include <stdio.h>
+#include <string.h>
+
+#include "ssd1306.h"
+#include "font8x8_basic.h"
+#include "font24x24_clock.h"
+#include "mock.h"
+#include "test.h"
+
+// font24x24_clock_tr is checked in, generated by the procedure in its header.  That
+// procedure is `_scale()` below.  It is first held against the scaling kernel that
+// ssd1306_compose_text_x3() still runs for the characters not in the table, and then
+// against every glyph in the table.
+
+static char const _glyphs[] = "0123456789: ";
+
+// the generator from the header of font24x24_clock.c
+static void
+_scale(char const ch, int const variant, uint8_t out[3][24])
+{
+    uint8_t const * const in = font8x8_basic_tr[(uint8_t)ch];
+    uint32_t cols[8] = {0};
+    for (int x = 0; x < 8; x++) {
+        for (int y = 0; y < 8; y++) {
+            if (in[x] & (1 << y)) cols[x] |= 7UL << (3 * y);
+        }
+    }
+    for (int p = 0; p < 3; p++) {
+        for (int x = 0; x < 24; x++) {
+            uint8_t b = cols[x / 3] >> (8 * p);
+            if (variant & 1) b = ~b;
+            if (variant & 2) b = ssd1306_rotate_byte(b);
+            out[p][x] = b;
+        }
+    }
+}
+
+static void
+_panel(SSD1306_t * const dev, int const variant)
+{
+    mock_reset();
+    memset(dev, 0, sizeof(SSD1306_t));
+    i2c_master_init(dev, CONFIG_SSD1306_SDA_GPIO, CONFIG_SSD1306_SCL_GPIO, CONFIG_SSD1306_RESET_GPIO);
+    ssd1306_init(dev, 128, 32);
+    dev->_flip = variant & 2;
+}
+
+static bool
+_composed_equals(SSD1306_t const * const dev, uint8_t const glyph[3][24])
+{
+    for (int p = 0; p < 3; p++) {
+        if (memcmp(dev->_page[p]._segs, glyph[p], 24) != 0) return false;
+    }
+    return true;
+}
+
+// the generator scales like the kernel does, for all the characters outside the table
+static void
+test_generator(void)
+{
+    for (int variant = 0; variant < FONT24X24_CLOCK_VARIANTS; variant++) {
+        SSD1306_t dev;
+        _panel(&dev, variant);
+        for (int ch = 1; ch < 128; ch++) {
+            if (font24x24_clock_idx(ch) >= 0) continue;
+            char const str[1] = { ch };
+            ssd1306_compose_text_x3(&dev, 0, 0, str, 1, variant & 1);
+            uint8_t expected[3][24];
+            _scale(ch, variant, expected);
+            if (!_composed_equals(&dev, expected)) {
+                fprintf(stderr, "0x%02X in variant %d\n", ch, variant);
+                test_failures++;
+            }
+        }
+    }
+}
+
+// every glyph of the table, as generated, and as composed
+static void
+test_table(void)
+{
+    for (int variant = 0; variant < FONT24X24_CLOCK_VARIANTS; variant++) {
+        SSD1306_t dev;
+        _panel(&dev, variant);
+        for (int ii = 0; _glyphs[ii]; ii++) {
+            int const idx = font24x24_clock_idx(_glyphs[ii]);
+            CHECK_EQ(idx, ii);
+            uint8_t expected[3][24];
+            _scale(_glyphs[ii], variant, expected);
+            if (memcmp(font24x24_clock_tr[variant][idx], expected, sizeof(expected)) != 0) {
+                fprintf(stderr, "'%c' in variant %d\n", _glyphs[ii], variant);
+                test_failures++;
+            }
+            ssd1306_compose_text_x3(&dev, 0, 0, &_glyphs[ii], 1, variant & 1);
+            CHECK(_composed_equals(&dev, expected));
+        }
+    }
+    CHECK_EQ(sizeof(_glyphs) - 1, FONT24X24_CLOCK_GLYPHS);
+}
+
+// a clock of table glyphs, against as many glyphs through the scaling kernel
+static void
+test_bench(void)
+{
+    SSD1306_t dev;
+    _panel(&dev, 0);
+    uint const rounds = 20000;
+    char const * const texts[] = { "12:34", "ABCDE" };
+    uint64_t ns[2];
+    for (uint tt = 0; tt < 2; tt++) {
+        uint64_t const start = test_ns();
+        for (uint ii = 0; ii < rounds; ii++) {
+            ssd1306_compose_text_x3(&dev, 0, 0, texts[tt], 5, ii & 1);
+        }
+        ns[tt] = (test_ns() - start) / rounds;
+    }
+    printf("  5 glyphs: %4llu ns from the table, %4llu ns through the kernel\n",
+           (unsigned long long)ns[0], (unsigned long long)ns[1]);
+}
+
+int
+main(void)
+{
+    TEST_RUN(test_generator);
+    TEST_RUN(test_table);
+    TEST_RUN(test_bench);
+    TEST_EXIT();
+}
@@ -0,0 +1,113 @@
+/**
+ * @brief test_font_prop, the proportional font against the 8x8 one it replaced on the status line
+ *
+ * © Copyright 2016, 2022, Sander and Coert Vonk
+ *
+ * This file is part of CALalarm.
+ *
+ * CALalarm is free software: you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * CALalarm is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with CALalarm.
+ * If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ **/
+
+#include <stdio.h>
+#include <string.h>
+
+#include "ssd1306.h"
+#include "font_prop.h"
+#include "mock.h"
+#include "test.h"
+
+static char const _status[] = "Tue 07:30 Dentist appointment";
+
+static void
+_panel(SSD1306_t * const dev)
+{
+    mock_reset();
+    memset(dev, 0, sizeof(SSD1306_t));
+    i2c_master_init(dev, CONFIG_SSD1306_SDA_GPIO, CONFIG_SSD1306_SCL_GPIO, CONFIG_SSD1306_RESET_GPIO);
+    ssd1306_init(dev, 128, 32);
+    ssd1306_clear_screen(dev, false);
+}
+
+// the columns used are the ones ssd1306_text_width_prop() predicts, and the text
+// stays within its `width`
+static void
+test_compose(void)
+{
+    SSD1306_t dev;
+    _panel(&dev);
+    memset(dev._page[3]._segs, 0x55, dev._width);
+    int const used = ssd1306_compose_text_prop(&dev, 3, 8, "Hi!", 40, false);
+    CHECK_EQ(used, ssd1306_text_width_prop("Hi!"));
+    CHECK_EQ(dev._page[3]._segs[7], 0x55);
+    CHECK_EQ(dev._page[3]._segs[48], 0x55);
+    for (int xx = 8 + used; xx < 48; xx++) {
+        CHECK_EQ(dev._page[3]._segs[xx], 0x00);
+    }
+    int const h = 'H' - FONT_PROP_FIRST;
+    CHECK(memcmp(&dev._page[3]._segs[8], &font_prop_atlas[font_prop_offset[h]], font_prop_width[h]) == 0);
+
+    // clipped
+    CHECK(ssd1306_text_width_prop(_status) > dev._width);
+    CHECK_EQ(ssd1306_compose_text_prop(&dev, 3, 0, _status, dev._width, false), dev._width);
+}
+
+// a status line each way, in CPU time, and in what goes over the bus
+static void
+test_bench(void)
+{
+    SSD1306_t dev;
+    _panel(&dev);
+    uint const rounds = 20000;
+    int const len = strlen(_status);
+
+    uint64_t start = test_ns();
+    for (uint ii = 0; ii < rounds; ii++) {
+        ssd1306_compose_text(&dev, 3, 0, _status, len, ii & 1);
+    }
+    uint64_t const fixed_ns = (test_ns() - start) / rounds;
+    start = test_ns();
+    for (uint ii = 0; ii < rounds; ii++) {
+        ssd1306_compose_text_prop(&dev, 3, 0, _status, dev._width, ii & 1);
+    }
+    uint64_t const prop_ns = (test_ns() - start) / rounds;
+
+    ssd1306_stats_t fixed, prop;
+    ssd1306_show_dirty(&dev);  // so only the status line goes out below
+    ssd1306_get_stats(&dev, &fixed, true);
+    ssd1306_display_text(&dev, 3, (char *)_status, len, true);
+    ssd1306_get_stats(&dev, &fixed, true);
+    ssd1306_compose_text_prop(&dev, 3, 0, _status, dev._width, false);
+    ssd1306_show_dirty(&dev);
+    ssd1306_get_stats(&dev, &prop, true);
+
+    int fits = 0;
+    for (char const * t = _status; *t; t++) {
+        char prefix[sizeof(_status)] = {0};
+        memcpy(prefix, _status, t - _status + 1);
+        if (ssd1306_text_width_prop(prefix) <= dev._width) fits++;
+    }
+    printf("  8x8:  %2u chars, %5llu ns to compose, %4u bytes %2u transactions on the bus\n",
+           dev._width / 8, (unsigned long long)fixed_ns, fixed.bytes, fixed.transactions);
+    printf("  prop: %2u chars, %5llu ns to compose, %4u bytes %2u transactions on the bus\n",
+           fits, (unsigned long long)prop_ns, prop.bytes, prop.transactions);
+    CHECK(fits > dev._width / 8);
+}
+
+int
+main(void)
+{
+    TEST_RUN(test_compose);
+    TEST_RUN(test_bench);
+    TEST_EXIT();
+}
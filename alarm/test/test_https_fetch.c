@@ -0,0 +1,166 @@
+/**
+ * @brief test_https_fetch, connections kept between polls, against a stand-in server
+ *
+ * © Copyright 2016, 2022, Sander and Coert Vonk
+ *
+ * This file is part of CALalarm.
+ *
+ * CALalarm is free software: you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * CALalarm is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with CALalarm.
+ * If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ **/
+
+#include <stdio.h>
+#include <string.h>
+
+#include "https_fetch.h"
+#include "mock_http.h"
+#include "test.h"
+
+// The body is collected as https_client_task parses it: from the start, again when it
+// starts over.
+
+#define URL "https://" MOCK_HTTP_SCRIPT "/macros/s/AKfycb/exec?devName=alarm&pushId=&hash="
+
+static char const _calendar[] = "{\"time\":\"2022-04-20 13:18:37\",\"pushId\":\"abc-123\",\"events\":[]}";
+
+static struct {
+    char data[256];
+    size_t len;
+    uint starts;
+} _body;
+
+static void
+_body_cb(void * const ctx, char const * const data, int const len)
+{
+    if (!data) {
+        _body.len = 0;
+        _body.starts++;
+        return;
+    }
+    memcpy(_body.data + _body.len, data, len);
+    _body.len += len;
+    _body.data[_body.len] = '\0';
+}
+
+static int
+_get(https_fetch_t * const f)
+{
+    memset(&_body, 0, sizeof(_body));
+    return https_fetch_get(f, URL);
+}
+
+static void
+_check_handshakes(uint const script, uint const content)
+{
+    CHECK_EQ(mock_http.hosts[0].handshakes, script);
+    CHECK_EQ(mock_http.hosts[1].handshakes, content);
+    CHECK_EQ(mock_http.hosts[0].lookups, script);
+    CHECK_EQ(mock_http.hosts[1].lookups, content);
+}
+
+// the first poll connects to both hosts, the redirect's body is not the calendar
+static void
+test_first(void)
+{
+    mock_http_reset(_calendar, 7);
+    https_fetch_t f;
+    https_fetch_init(&f, _body_cb, NULL);
+
+    CHECK_EQ(_get(&f), 200);
+    CHECK(strcmp(_body.data, _calendar) == 0);
+    _check_handshakes(1, 1);
+    CHECK_EQ(f.conns[HTTPS_HOST_SCRIPT].connects, 1);
+    CHECK_EQ(f.conns[HTTPS_HOST_CONTENT].connects, 1);
+
+    // the stamp is bracketed by the request to the script host
+    CHECK(f.send_us > 0);
+    CHECK(f.recv_us >= f.send_us);
+    CHECK(f.conns[HTTPS_HOST_SCRIPT].phases.header_us >= f.conns[HTTPS_HOST_SCRIPT].phases.sent_us);
+    CHECK(f.conns[HTTPS_HOST_CONTENT].phases.finish_us >= f.conns[HTTPS_HOST_CONTENT].phases.header_us);
+}
+
+// later polls reuse both connections, without DNS or handshakes
+static void
+test_keep_alive(void)
+{
+    mock_http_reset(_calendar, 64);
+    https_fetch_t f;
+    https_fetch_init(&f, _body_cb, NULL);
+
+    for (uint poll = 0; poll < 10; poll++) {
+        CHECK_EQ(_get(&f), 200);
+        CHECK(strcmp(_body.data, _calendar) == 0);
+    }
+    _check_handshakes(1, 1);
+    CHECK_EQ(mock_http.hosts[0].requests, 10);
+    CHECK_EQ(mock_http.hosts[1].requests, 10);
+    CHECK_EQ(f.conns[HTTPS_HOST_CONTENT].phases.connected_us, 0);  // reused
+    printf("  10 polls, %u handshakes, %u before\n",
+           mock_http.hosts[0].handshakes + mock_http.hosts[1].handshakes, 10 * MOCK_HTTP_HOSTS);
+}
+
+// when the servers closed the idle connections, each request is retried once on a new
+// one, and the body that arrives is the whole one
+static void
+test_closed(void)
+{
+    mock_http_reset(_calendar, 5);
+    https_fetch_t f;
+    https_fetch_init(&f, _body_cb, NULL);
+
+    CHECK_EQ(_get(&f), 200);
+    mock_http_close_idle();
+    CHECK_EQ(_get(&f), 200);
+    CHECK(strcmp(_body.data, _calendar) == 0);
+    _check_handshakes(2, 2);
+    CHECK_EQ(mock_http.hosts[0].requests, 2);
+    CHECK_EQ(mock_http.hosts[1].requests, 2);
+    CHECK(f.send_us >= f.conns[HTTPS_HOST_SCRIPT].phases.start_us);  // not from the failed attempt
+
+    // dropped halfway through the body
+    mock_http.drop_after = 20;
+    CHECK_EQ(_get(&f), 200);
+    CHECK(strcmp(_body.data, _calendar) == 0);
+    CHECK_EQ(_body.starts, 3);  // the script host, and the content host twice
+    _check_handshakes(2, 3);
+}
+
+static void
+test_redirects(void)
+{
+    mock_http_reset(_calendar, 64);
+    mock_http.redirect_loop = true;
+    https_fetch_t f;
+    https_fetch_init(&f, _body_cb, NULL);
+
+    CHECK_EQ(_get(&f), 302);
+    CHECK_EQ(_body.len, 0);
+    CHECK_EQ(mock_http.hosts[1].requests, HTTPS_MAX_REDIRECTS);
+    _check_handshakes(1, 1);
+
+    // a host that DNS doesn't know
+    mock_http_reset(_calendar, 64);
+    memset(&_body, 0, sizeof(_body));
+    CHECK_EQ(https_fetch_get(&f, "https://nowhere.example/exec"), -1);
+    _check_handshakes(0, 0);
+}
+
+int
+main(void)
+{
+    TEST_RUN(test_first);
+    TEST_RUN(test_keep_alive);
+    TEST_RUN(test_closed);
+    TEST_RUN(test_redirects);
+    TEST_EXIT();
+}
@@ -0,0 +1,187 @@
+/**
+ * @brief test_msg_pool, fixed block pool for the message payloads
+ *
+ * © Copyright 2016, 2022, Sander and Coert Vonk
+ *
+ * This file is part of CALalarm.
+ *
+ * CALalarm is free software: you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * CALalarm is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with CALalarm.
+ * If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ **/
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "msg_pool.h"
+#include "calendar_json.h"
+#include "test.h"
+
+// The pool is static, so each test returns all the blocks it took.
+
+static void
+test_classes(void)
+{
+    msg_pool_stats_t before, stats;
+    msg_pool_get_stats(&before);
+
+    char * const small = msg_pool_alloc(MSG_POOL_SMALL_SIZE);
+    char * const large = msg_pool_alloc(MSG_POOL_SMALL_SIZE + 1);
+    CHECK(small != NULL);
+    CHECK(large != NULL);
+    msg_pool_get_stats(&stats);
+    CHECK_EQ(stats.small_used, 1);
+    CHECK_EQ(stats.large_used, 1);
+
+    // the whole block can be used
+    memset(small, 0xA5, MSG_POOL_SMALL_SIZE);
+    memset(large, 0x5A, MSG_POOL_LARGE_SIZE);
+
+    CHECK(msg_pool_alloc(MSG_POOL_LARGE_SIZE + 1) == NULL);
+    msg_pool_get_stats(&stats);
+    CHECK_EQ(stats.failed, before.failed + 1);
+
+    msg_pool_free(small);
+    msg_pool_free(large);
+    msg_pool_free(NULL);
+    msg_pool_get_stats(&stats);
+    CHECK_EQ(stats.small_used, 0);
+    CHECK_EQ(stats.large_used, 0);
+    CHECK_EQ(stats.small_max, 1);
+    CHECK_EQ(stats.large_max, 1);
+}
+
+// blocks hold structs with 64-bit fields, such as calendar_json_payload_t
+static void
+test_alignment(void)
+{
+    void * const small = msg_pool_alloc(1);
+    void * const large = msg_pool_alloc(MSG_POOL_LARGE_SIZE);
+    CHECK((uintptr_t)small % _Alignof(max_align_t) == 0);
+    CHECK((uintptr_t)large % _Alignof(max_align_t) == 0);
+    msg_pool_free(small);
+    msg_pool_free(large);
+
+    CHECK(sizeof(calendar_json_payload_t) <= MSG_POOL_LARGE_SIZE);
+}
+
+// when the small blocks run out, the large ones are used, and then nothing
+static void
+test_exhaust(void)
+{
+    void * blocks[MSG_POOL_SMALL_CNT + MSG_POOL_LARGE_CNT];
+    msg_pool_stats_t before, stats;
+    msg_pool_get_stats(&before);
+
+    for (uint ii = 0; ii < MSG_POOL_SMALL_CNT + MSG_POOL_LARGE_CNT; ii++) {
+        blocks[ii] = msg_pool_alloc(1);
+        CHECK(blocks[ii] != NULL);
+        for (uint jj = 0; jj < ii; jj++) {
+            CHECK(blocks[ii] != blocks[jj]);
+        }
+    }
+    msg_pool_get_stats(&stats);
+    CHECK_EQ(stats.small_used, MSG_POOL_SMALL_CNT);
+    CHECK_EQ(stats.large_used, MSG_POOL_LARGE_CNT);
+    CHECK(msg_pool_alloc(1) == NULL);
+    msg_pool_get_stats(&stats);
+    CHECK_EQ(stats.failed, before.failed + 1);
+
+    // a returned block is handed out again
+    void * const reused = blocks[3];
+    msg_pool_free(reused);
+    CHECK(msg_pool_alloc(1) == reused);
+
+    for (uint ii = 0; ii < MSG_POOL_SMALL_CNT + MSG_POOL_LARGE_CNT; ii++) {
+        msg_pool_free(blocks[ii]);
+    }
+    msg_pool_get_stats(&stats);
+    CHECK_EQ(stats.small_used, 0);
+    CHECK_EQ(stats.large_used, 0);
+    CHECK_EQ(stats.small_max, MSG_POOL_SMALL_CNT);
+    CHECK_EQ(stats.large_max, MSG_POOL_LARGE_CNT);
+}
+
+static void
+test_strdup(void)
+{
+    char const * const str = "Dentist at 10:30";
+    char * const copy = msg_pool_strdup(str);
+    CHECK(copy != NULL);
+    CHECK(copy != str);
+    CHECK(strcmp(copy, str) == 0);
+    msg_pool_free(copy);
+
+    // a string that needs more than a small block
+    char long_str[MSG_POOL_SMALL_SIZE + 10];
+    memset(long_str, 'x', sizeof(long_str) - 1);
+    long_str[sizeof(long_str) - 1] = '\0';
+    char * const long_copy = msg_pool_strdup(long_str);
+    CHECK(long_copy != NULL);
+    CHECK(strcmp(long_copy, long_str) == 0);
+    msg_pool_stats_t stats;
+    msg_pool_get_stats(&stats);
+    CHECK_EQ(stats.large_used, 1);
+    msg_pool_free(long_copy);
+}
+
+// a pointer that the pool didn't hand out, or one it already got back, is counted and
+// left alone, so it can't corrupt the blocks in use
+static void
+test_foreign(void)
+{
+    msg_pool_stats_t before, stats;
+    msg_pool_get_stats(&before);
+
+    char * const small = msg_pool_alloc(1);
+    char * const large = msg_pool_alloc(MSG_POOL_LARGE_SIZE);
+    char stack[8];
+    msg_pool_free(stack);
+    msg_pool_free(small + 1);  // inside the block
+    msg_pool_free(large + MSG_POOL_SMALL_SIZE);
+    msg_pool_get_stats(&stats);
+    CHECK_EQ(stats.foreign, before.foreign + 3);
+    CHECK_EQ(stats.small_used, 1);
+    CHECK_EQ(stats.large_used, 1);
+
+    msg_pool_free(small);
+    msg_pool_free(large);
+    msg_pool_free(small);  // twice
+    msg_pool_get_stats(&stats);
+    CHECK_EQ(stats.foreign, before.foreign + 4);
+    CHECK_EQ(stats.small_used, 0);
+    CHECK_EQ(stats.large_used, 0);
+
+    // the pool is still whole
+    void * blocks[MSG_POOL_SMALL_CNT];
+    for (uint ii = 0; ii < MSG_POOL_SMALL_CNT; ii++) {
+        blocks[ii] = msg_pool_alloc(1);
+    }
+    msg_pool_get_stats(&stats);
+    CHECK_EQ(stats.small_used, MSG_POOL_SMALL_CNT);
+    CHECK_EQ(stats.large_used, 0);
+    for (uint ii = 0; ii < MSG_POOL_SMALL_CNT; ii++) {
+        msg_pool_free(blocks[ii]);
+    }
+}
+
+int
+main(void)
+{
+    TEST_RUN(test_classes);
+    TEST_RUN(test_alignment);
+    TEST_RUN(test_exhaust);
+    TEST_RUN(test_strdup);
+    TEST_RUN(test_foreign);
+    TEST_EXIT();
+}
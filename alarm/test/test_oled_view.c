@@ -0,0 +1,271 @@
+/**
+ * @brief test_oled_view, renders each kind of frame that display_task shows, on the emulated panel
+ *
+ * © Copyright 2016, 2022, Sander and Coert Vonk
+ *
+ * This file is part of CALalarm.
+ *
+ * CALalarm is free software: you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * CALalarm is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with CALalarm.
+ * If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ **/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "ssd1306.h"
+#include "oled_view.h"
+#include "mock.h"
+#include "test.h"
+
+// Each frame goes through ssd1306_show_dirty() to the emulated panel, is compared with
+// what was composed, and left in the build directory as a PBM.  That must match the one
+// in golden/; after an intended change to the layout, look at the new ones and run with
+// UPDATE_GOLDEN=1 to copy them over.
+
+#define STATUS_PAGE (3)
+#define LINK_SEG (128 - 2 * 8)
+
+static void
+_panel(SSD1306_t * const dev)
+{
+    mock_reset();
+    memset(dev, 0, sizeof(SSD1306_t));
+    i2c_master_init(dev, CONFIG_SSD1306_SDA_GPIO, CONFIG_SSD1306_SCL_GPIO, CONFIG_SSD1306_RESET_GPIO);
+    ssd1306_init(dev, 128, 32);
+}
+
+// render, send it to the panel, and check that the panel shows the frame
+static int
+_render(SSD1306_t * const dev, oled_view_t const * const view, char const * const name)
+{
+    int const marquee_page = oled_view_render(dev, view);
+    ssd1306_show_dirty(dev);
+    for (int page = 0; page < dev->_pages; page++) {
+        CHECK(memcmp(mock_panel.ram[page], dev->_page[page]._segs, dev->_width) == 0);
+    }
+    CHECK_EQ(mock_panel.stats.unknown, 0);
+    CHECK_EQ(mock_stats.errors, 0);
+
+    char * frame = NULL;
+    size_t frame_len = 0;
+    FILE * const mem = open_memstream(&frame, &frame_len);
+    ssd1306_emu_pbm(&mock_panel, mem);
+    fclose(mem);
+
+    char const * const update = getenv("UPDATE_GOLDEN");
+    char const * const dirs[] = { TEST_OUTPUT_DIR, update && *update == '1' ? GOLDEN_DIR : NULL };
+    for (uint ii = 0; ii < sizeof(dirs) / sizeof(dirs[0]) && dirs[ii]; ii++) {
+        char pbm[256];
+        snprintf(pbm, sizeof(pbm), "%s/oled_view_%s.pbm", dirs[ii], name);
+        FILE * const f = fopen(pbm, "w");
+        CHECK(f != NULL);
+        if (f) {
+            fwrite(frame, 1, frame_len, f);
+            fclose(f);
+        }
+    }
+
+    char golden[256];
+    snprintf(golden, sizeof(golden), GOLDEN_DIR "/oled_view_%s.pbm", name);
+    static char expected[8192];
+    FILE * const f = fopen(golden, "r");
+    size_t const expected_len = f ? fread(expected, 1, sizeof(expected), f) : 0;
+    if (f) {
+        fclose(f);
+    }
+    if (expected_len != frame_len || memcmp(expected, frame, frame_len) != 0) {
+        fprintf(stderr, "%s: differs from " TEST_OUTPUT_DIR "/oled_view_%s.pbm\n", golden, name);
+        test_failures++;
+    }
+    free(frame);
+    return marquee_page;
+}
+
+static bool
+_blank(uint8_t const * const segs, int const len)
+{
+    for (int ii = 0; ii < len; ii++) {
+        if (segs[ii]) return false;
+    }
+    return true;
+}
+
+// a status of about `width` columns
+static void
+_status_of_width(char * const status, size_t const size, int const width)
+{
+    status[0] = '\0';
+    for (size_t len = 0; len < size - 1 && ssd1306_text_width_prop(status) < width; len++) {
+        status[len] = 'a' + len % 26;
+        status[len + 1] = '\0';
+    }
+}
+
+// before the time is known, the clock is blank
+static void
+test_no_clock(void)
+{
+    SSD1306_t dev;
+    _panel(&dev);
+    oled_view_t view = {};
+
+    CHECK_EQ(_render(&dev, &view, "no_clock"), -1);
+    for (int page = 0; page < STATUS_PAGE; page++) {
+        CHECK(_blank(dev._page[page]._segs, dev._width));
+    }
+}
+
+static void
+test_clock(void)
+{
+    SSD1306_t dev;
+    _panel(&dev);
+    oled_view_t view = {};
+
+    struct tm tm = { .tm_hour = 0, .tm_min = 5 };
+    oled_view_set_time(&view, &tm);
+    CHECK(view.clock);
+    CHECK_EQ(view.hrs, 12);
+    CHECK_EQ(view.min, 5);
+    CHECK(!view.pm);
+
+    tm.tm_hour = 12;
+    oled_view_set_time(&view, &tm);
+    CHECK_EQ(view.hrs, 12);
+    CHECK(view.pm);
+
+    tm.tm_hour = 23;
+    tm.tm_min = 59;
+    oled_view_set_time(&view, &tm);
+    CHECK_EQ(view.hrs, 11);
+    CHECK(view.pm);
+
+    CHECK_EQ(_render(&dev, &view, "clock"), -1);
+
+    // digits at the left, "PM" stacked at the right
+    SSD1306_t ref = dev;
+    ssd1306_compose_text_x3(&ref, 0, 0, "11:59", 5, false);
+    ssd1306_compose_text(&ref, 0, 120, "P", 1, false);
+    ssd1306_compose_text(&ref, 1, 120, "M", 1, false);
+    for (int page = 0; page < STATUS_PAGE; page++) {
+        CHECK(memcmp(dev._page[page]._segs, ref._page[page]._segs, dev._width) == 0);
+    }
+}
+
+static void
+test_status(void)
+{
+    SSD1306_t dev;
+    _panel(&dev);
+    oled_view_t view = {};
+
+    oled_view_set_status(&view, "Dentist", false);
+    CHECK_EQ(_render(&dev, &view, "status"), -1);
+
+    SSD1306_t ref = dev;
+    ssd1306_compose_text_prop(&ref, STATUS_PAGE, 0, "Dentist", 128, false);
+    CHECK(memcmp(dev._page[STATUS_PAGE]._segs, ref._page[STATUS_PAGE]._segs, dev._width) == 0);
+}
+
+static void
+test_status_link(void)
+{
+    SSD1306_t dev;
+    _panel(&dev);
+    oled_view_t view = {};
+
+    oled_view_set_status(&view, "Dentist", true);
+    CHECK_EQ(_render(&dev, &view, "link"), -1);
+
+    SSD1306_t ref = dev;
+    ssd1306_compose_text(&ref, STATUS_PAGE, LINK_SEG, "\x03\x04", 2, false);
+    CHECK(!_blank(&dev._page[STATUS_PAGE]._segs[LINK_SEG], 16));
+    CHECK(memcmp(&dev._page[STATUS_PAGE]._segs[LINK_SEG], &ref._page[STATUS_PAGE]._segs[LINK_SEG], 16) == 0);
+}
+
+// too wide next to the link symbol, but it fits the page the controller rotates
+static void
+test_marquee_hardware(void)
+{
+    SSD1306_t dev;
+    _panel(&dev);
+    oled_view_t view = {};
+
+    char status[OLED_VIEW_STATUS_LEN];
+    _status_of_width(status, sizeof(status), 116);
+    oled_view_set_status(&view, status, true);
+    CHECK_EQ(_render(&dev, &view, "marquee_hw"), STATUS_PAGE);
+
+    // the whole text, then the gap where it wraps around
+    SSD1306_t ref = dev;
+    ssd1306_compose_text_prop(&ref, STATUS_PAGE, 0, status, 128, false);
+    CHECK(memcmp(dev._page[STATUS_PAGE]._segs, ref._page[STATUS_PAGE]._segs, dev._width) == 0);
+    int const width = ssd1306_text_width_prop(status);
+    CHECK(_blank(&dev._page[STATUS_PAGE]._segs[width], dev._width - width));
+}
+
+// too long even for the page the controller rotates, so it is cut short with an
+// ellipsis, and still scrolls in hardware
+static void
+test_marquee_ellipsis(void)
+{
+    SSD1306_t dev;
+    _panel(&dev);
+    oled_view_t view = {};
+
+    char status[OLED_VIEW_STATUS_LEN];
+    _status_of_width(status, sizeof(status), 200);
+    oled_view_set_status(&view, status, true);
+    CHECK_EQ(_render(&dev, &view, "marquee_ellipsis"), STATUS_PAGE);
+
+    // as much of the text as fits with the ellipsis, then the gap where it wraps around
+    int const loop_gap = 8;
+    int const ellipsis = ssd1306_text_width_prop("...");
+    char expected[OLED_VIEW_STATUS_LEN + 3];
+    int len = 0;
+    do {
+        snprintf(expected, sizeof(expected), "%.*s...", ++len, status);
+    } while (ssd1306_text_width_prop(expected) + loop_gap <= 128);
+    snprintf(expected, sizeof(expected), "%.*s...", len - 1, status);
+    int const width = ssd1306_text_width_prop(expected);
+    CHECK(width > 128 - loop_gap - ellipsis - 8);
+
+    SSD1306_t ref = dev;
+    ssd1306_compose_text_prop(&ref, STATUS_PAGE, 0, expected, 128, false);
+    CHECK(memcmp(dev._page[STATUS_PAGE]._segs, ref._page[STATUS_PAGE]._segs, dev._width) == 0);
+    CHECK(_blank(&dev._page[STATUS_PAGE]._segs[width], dev._width - width));
+    CHECK(dev._width - width >= loop_gap);
+
+    // trailing spaces don't end up in front of the ellipsis
+    char spaced[2 * OLED_VIEW_STATUS_LEN];
+    snprintf(spaced, sizeof(spaced), "%.*s     %s", len - 2, status, status);
+    oled_view_set_status(&view, spaced, false);
+    CHECK_EQ(_render(&dev, &view, "marquee_ellipsis_spaced"), STATUS_PAGE);
+    snprintf(expected, sizeof(expected), "%.*s...", len - 2, status);
+    ssd1306_compose_text_prop(&ref, STATUS_PAGE, 0, expected, 128, false);
+    CHECK(memcmp(dev._page[STATUS_PAGE]._segs, ref._page[STATUS_PAGE]._segs, dev._width) == 0);
+}
+
+int
+main(void)
+{
+    TEST_RUN(test_no_clock);
+    TEST_RUN(test_clock);
+    TEST_RUN(test_status);
+    TEST_RUN(test_status_link);
+    TEST_RUN(test_marquee_hardware);
+    TEST_RUN(test_marquee_ellipsis);
+    TEST_EXIT();
+}
@@ -0,0 +1,140 @@
+/**
+ * @brief test_poll_schedule, the polling interval from learned edit rates and the next alarm
+ *
+ * © Copyright 2016, 2022, Sander and Coert Vonk
+ *
+ * This file is part of CALalarm.
+ *
+ * CALalarm is free software: you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * CALalarm is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with CALalarm.
+ * If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ **/
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "poll_schedule.h"
+#include "test.h"
+
+#define BASE_S (12 * 60)
+#define MAX_S (60 * 60)
+
+static time_t const _monday = 1700438400;  // 2023-11-20 00:00 UTC, hours are UTC here
+
+static uint
+_hour(time_t const t)
+{
+    return t / 3600 % 24;
+}
+
+static void
+test_initial(void)
+{
+    poll_schedule_t ps;
+    poll_schedule_init(&ps, BASE_S, MAX_S);
+    for (uint hour = 0; hour < POLL_SCHEDULE_HOURS; hour++) {
+        uint32_t const interval = poll_schedule_interval(&ps, _monday, hour, false);
+        CHECK(interval >= BASE_S - 1 && interval <= BASE_S);
+    }
+    // with push notifications, only the alarms matter
+    CHECK_EQ(poll_schedule_interval(&ps, _monday, 0, true), MAX_S);
+}
+
+static void
+test_alarms(void)
+{
+    poll_schedule_t ps;
+    poll_schedule_init(&ps, BASE_S, MAX_S);
+    time_t const now = _monday;
+
+    poll_schedule_add_alarm(&ps, now - 60);    // went off already
+    poll_schedule_add_alarm(&ps, now + 3600);
+    poll_schedule_add_alarm(&ps, now + 600);
+    CHECK_EQ(poll_schedule_interval(&ps, now, 0, true), 300);
+    CHECK_EQ(poll_schedule_interval(&ps, now, 0, false), 300);
+
+    // closing in on it, but not more often than the minimum
+    CHECK_EQ(poll_schedule_interval(&ps, now + 500, 0, true), POLL_SCHEDULE_MIN_S);
+
+    poll_schedule_clear_alarms(&ps);
+    CHECK_EQ(poll_schedule_interval(&ps, now, 0, true), MAX_S);
+
+    // more than it holds are ignored
+    for (uint ii = 0; ii < POLL_SCHEDULE_ALARMS + 4; ii++) {
+        poll_schedule_add_alarm(&ps, now + 7200 + ii);
+    }
+    CHECK_EQ(ps.alarms_len, POLL_SCHEDULE_ALARMS);
+}
+
+// Four weeks of a calendar that is edited every 30 minutes during office hours, and
+// never at night.  The office hours, and the hour before them, learn to poll about ten
+// times per edit, the night falls back to the longest interval.
+static void
+test_learn(void)
+{
+    poll_schedule_t ps;
+    poll_schedule_init(&ps, BASE_S, MAX_S);
+
+    time_t const edit_s = 30 * 60;
+    time_t now = _monday;
+    time_t last_poll = now;
+    while (now < _monday + 28 * 86400) {
+        uint const hour = _hour(now);
+        bool changed = false;
+        for (time_t t = last_poll - last_poll % edit_s + edit_s; t <= now; t += edit_s) {
+            changed |= _hour(t) >= 9 && _hour(t) < 17;
+        }
+        poll_schedule_polled(&ps, now, hour, changed);
+        last_poll = now;
+        now += poll_schedule_interval(&ps, now, hour, false);
+    }
+
+    uint32_t const office = poll_schedule_interval(&ps, now, 11, false);
+    uint32_t const before = poll_schedule_interval(&ps, now, 8, false);
+    uint32_t const night = poll_schedule_interval(&ps, now, 2, false);
+    printf("  office hours %u s, the hour before %u s, at night %u s\n", office, before, night);
+    CHECK(office >= POLL_SCHEDULE_MIN_S && office <= edit_s / POLL_SCHEDULE_POLLS_PER_EDIT * 2);
+    CHECK(before >= POLL_SCHEDULE_MIN_S && before <= edit_s / POLL_SCHEDULE_POLLS_PER_EDIT * 2);
+    CHECK_EQ(night, MAX_S);
+}
+
+// a long outage counts as at most an hour, so it doesn't wipe out what was learned
+static void
+test_outage(void)
+{
+    poll_schedule_t ps;
+    poll_schedule_init(&ps, BASE_S, MAX_S);
+    time_t now = _monday;
+    poll_schedule_polled(&ps, now, 0, false);
+    poll_schedule_hour_t const before = ps.hours[0];
+
+    now += 7 * 86400;
+    poll_schedule_polled(&ps, now, 0, false);
+    CHECK(ps.hours[0].observed_s <= before.observed_s + 3600);
+    CHECK(ps.hours[0].changes_q16 >= before.changes_q16 - before.changes_q16 * 3600 / POLL_SCHEDULE_MEMORY_S - 1);
+
+    // the clock going back is ignored
+    poll_schedule_hour_t const after = ps.hours[0];
+    poll_schedule_polled(&ps, now - 60, 0, true);
+    CHECK_EQ(ps.hours[0].changes_q16, after.changes_q16);
+}
+
+int
+main(void)
+{
+    TEST_RUN(test_initial);
+    TEST_RUN(test_alarms);
+    TEST_RUN(test_learn);
+    TEST_RUN(test_outage);
+    TEST_EXIT();
+}
@@ -0,0 +1,300 @@
+/**
+ * @brief test_schedule, the events of the next 48 hours and their alarm heap
+ *
+ * © Copyright 2016, 2022, Sander and Coert Vonk
+ *
+ * This file is part of CALalarm.
+ *
+ * CALalarm is free software: you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * CALalarm is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with CALalarm.
+ * If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ **/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "schedule.h"
+#include "test.h"
+
+static time_t const _now = 1700000000;
+
+static void
+_apply(schedule_t * const s, char const * const * const titles, time_t const * const alarms, uint const len, time_t const now)
+{
+    schedule_begin(s);
+    for (uint ii = 0; ii < len; ii++) {
+        // the event starts 10 minutes after its alarm, and lasts an hour
+        CHECK(schedule_add(s, titles[ii], alarms[ii], alarms[ii] + 600, alarms[ii] + 4200, now));
+    }
+    schedule_end(s, true);
+}
+
+static void
+test_order_and_alarms(void)
+{
+    schedule_t s;
+    schedule_init(&s);
+    CHECK(schedule_next_alarm(&s) == NULL);
+
+    char const * const titles[] = { "Lunch", "Dentist", "Standup" };
+    time_t const alarms[] = { _now + 7200, _now + 3600, _now - 60 };
+    _apply(&s, titles, alarms, 3, _now);
+
+    // by start time, the one that already went off too
+    CHECK(strcmp(schedule_title(&s, schedule_at(&s, 0)), "Standup") == 0);
+    CHECK(strcmp(schedule_title(&s, schedule_at(&s, 1)), "Dentist") == 0);
+    CHECK(strcmp(schedule_title(&s, schedule_at(&s, 2)), "Lunch") == 0);
+    CHECK(schedule_at(&s, 3) == NULL);
+
+    // but only the alarms to come
+    schedule_event_t const * next = schedule_next_alarm(&s);
+    CHECK(next != NULL && strcmp(schedule_title(&s, next), "Dentist") == 0);
+    schedule_pop_alarm(&s);
+    next = schedule_next_alarm(&s);
+    CHECK(next != NULL && strcmp(schedule_title(&s, next), "Lunch") == 0);
+    schedule_pop_alarm(&s);
+    CHECK(schedule_next_alarm(&s) == NULL);
+    schedule_pop_alarm(&s);  // nothing left, no effect
+    CHECK(schedule_next_alarm(&s) == NULL);
+}
+
+// the same window again doesn't bring back an alarm that went off, a moved one is new
+static void
+test_resend(void)
+{
+    schedule_t s;
+    schedule_init(&s);
+
+    char const * const titles[] = { "Dentist", "Lunch" };
+    time_t alarms[] = { _now + 3600, _now + 7200 };
+    _apply(&s, titles, alarms, 2, _now);
+    schedule_pop_alarm(&s);  // Dentist went off
+
+    _apply(&s, titles, alarms, 2, _now + 3601);
+    schedule_event_t const * next = schedule_next_alarm(&s);
+    CHECK(next != NULL && strcmp(schedule_title(&s, next), "Lunch") == 0);
+
+    // Dentist moved to later, so it has an alarm again
+    alarms[0] = _now + 10800;
+    _apply(&s, titles, alarms, 2, _now + 3602);
+    schedule_pop_alarm(&s);
+    next = schedule_next_alarm(&s);
+    CHECK(next != NULL && strcmp(schedule_title(&s, next), "Dentist") == 0);
+    CHECK_EQ(next->alarm, _now + 10800);
+    CHECK(schedule_at(&s, 2) == NULL);
+}
+
+// a complete payload removes what is missing from it, an incomplete one doesn't
+static void
+test_remove(void)
+{
+    schedule_t s;
+    schedule_init(&s);
+
+    char const * const titles[] = { "Dentist", "Lunch", "Gym" };
+    time_t const alarms[] = { _now + 3600, _now + 7200, _now + 9000 };
+    _apply(&s, titles, alarms, 3, _now);
+
+    schedule_begin(&s);
+    CHECK(schedule_add(&s, "Lunch", alarms[1], alarms[1] + 600, alarms[1] + 4200, _now));
+    schedule_end(&s, false);
+    CHECK(schedule_at(&s, 2) != NULL);
+
+    schedule_begin(&s);
+    CHECK(schedule_add(&s, "Lunch", alarms[1], alarms[1] + 600, alarms[1] + 4200, _now));
+    schedule_end(&s, true);
+    CHECK(schedule_at(&s, 1) == NULL);
+    schedule_event_t const * const next = schedule_next_alarm(&s);
+    CHECK(next != NULL && strcmp(schedule_title(&s, next), "Lunch") == 0);
+    schedule_pop_alarm(&s);
+    CHECK(schedule_next_alarm(&s) == NULL);
+}
+
+// when it is full, events that are not in the new payload make room
+static void
+test_full(void)
+{
+    schedule_t s;
+    schedule_init(&s);
+
+    schedule_begin(&s);
+    for (uint ii = 0; ii < SCHEDULE_MAX_EVENTS; ii++) {
+        CHECK(schedule_add(&s, "Old", _now + ii * 60, _now + ii * 60, _now + ii * 60 + 60, _now));
+    }
+    schedule_end(&s, true);
+
+    schedule_begin(&s);
+    for (uint ii = 0; ii < SCHEDULE_MAX_EVENTS; ii++) {
+        CHECK(schedule_add(&s, "New", _now + ii * 60 + 1, _now + ii * 60 + 1, _now + ii * 60 + 61, _now));
+    }
+    CHECK(!schedule_add(&s, "Extra", _now + 5, _now + 5, _now + 65, _now));
+    schedule_end(&s, true);
+
+    for (uint ii = 0; ii < SCHEDULE_MAX_EVENTS; ii++) {
+        schedule_event_t const * const event = schedule_at(&s, ii);
+        CHECK(event != NULL && strcmp(schedule_title(&s, event), "New") == 0);
+    }
+}
+
+// Random windows, against a model that keeps track of which events are in the
+// schedule, and which of their alarms are still to come.  The titles take more than
+// the pool over time, so it is compacted.
+
+#define UNIVERSE (64)
+
+typedef struct model_event_t {
+    char title[32];
+    time_t alarm, start, stop;
+    bool present, pending;
+} model_event_t;
+
+static int
+_find(model_event_t const * const universe, schedule_t const * const s, schedule_event_t const * const event)
+{
+    for (int ii = 0; ii < UNIVERSE; ii++) {
+        model_event_t const * const m = &universe[ii];
+        if (m->start == event->start && m->alarm == event->alarm && m->stop == event->stop &&
+            strcmp(m->title, schedule_title(s, event)) == 0) {
+            return ii;
+        }
+    }
+    return -1;
+}
+
+static void
+test_random(void)
+{
+    srand(1);
+    model_event_t universe[UNIVERSE] = {};
+    for (uint ii = 0; ii < UNIVERSE; ii++) {
+        model_event_t * const m = &universe[ii];
+        int const len = snprintf(m->title, sizeof(m->title), "event %u ", ii);
+        int const pad = 10 + rand() % 20;
+        for (int jj = len; jj < pad; jj++) {
+            m->title[jj] = 'a' + jj % 26;
+        }
+        m->alarm = _now + rand() % (48 * 3600);
+        m->start = m->alarm + 60 * (rand() % 30);
+        m->stop = m->start + 60 * (1 + rand() % 120);
+    }
+    // two events at the same time, with different titles
+    universe[1].alarm = universe[0].alarm;
+    universe[1].start = universe[0].start;
+    universe[1].stop = universe[0].stop;
+
+    schedule_t s;
+    schedule_init(&s);
+    time_t now = _now;
+    for (uint round = 0; round < 2000; round++) {
+        bool in[UNIVERSE] = {};
+        uint const cnt = rand() % (SCHEDULE_MAX_EVENTS + 1);
+        for (uint ii = 0; ii < cnt; ii++) {
+            in[rand() % UNIVERSE] = true;
+        }
+        schedule_begin(&s);
+        for (uint ii = 0; ii < UNIVERSE; ii++) {
+            model_event_t * const m = &universe[ii];
+            if (in[ii]) {
+                CHECK(schedule_add(&s, m->title, m->alarm, m->start, m->stop, now));
+                if (!m->present) {
+                    m->present = true;
+                    m->pending = m->alarm > now;
+                }
+            } else {
+                m->present = m->pending = false;
+            }
+        }
+        schedule_end(&s, true);
+
+        // the events by start time
+        uint len = 0;
+        time_t last = 0;
+        for (schedule_event_t const * event; (event = schedule_at(&s, len)); len++) {
+            CHECK(event->start >= last);
+            last = event->start;
+            int const ii = _find(universe, &s, event);
+            CHECK(ii >= 0 && universe[ii].present);
+        }
+        uint present = 0;
+        for (uint ii = 0; ii < UNIVERSE; ii++) {
+            present += universe[ii].present;
+        }
+        CHECK_EQ(len, present);
+
+        // time passes, and the alarms that are due go off in order
+        now += rand() % 1800;
+        time_t prev = 0;
+        for (schedule_event_t const * next; (next = schedule_next_alarm(&s)) && next->alarm <= now; ) {
+            CHECK(next->alarm >= prev);
+            prev = next->alarm;
+            int const ii = _find(universe, &s, next);
+            CHECK(ii >= 0 && universe[ii].pending);
+            if (ii >= 0) universe[ii].pending = false;
+            schedule_pop_alarm(&s);
+        }
+        time_t first = 0;
+        for (uint ii = 0; ii < UNIVERSE; ii++) {
+            if (universe[ii].pending && (!first || universe[ii].alarm < first)) {
+                first = universe[ii].alarm;
+            }
+        }
+        schedule_event_t const * const next = schedule_next_alarm(&s);
+        CHECK_EQ(next ? next->alarm : 0, first);
+        if (test_failures) {
+            fprintf(stderr, "in round %u\n", round);
+            return;
+        }
+    }
+}
+
+// when the display task wakes up: the next minute, or the alarm if that comes first
+static void
+test_deadline(void)
+{
+    schedule_t s;
+    schedule_init(&s);
+    time_t const minute = _now - _now % 60;
+    int64_t const now_ms = (int64_t)minute * 1000 + 12345;
+    CHECK_EQ(schedule_ms_until_deadline(&s, now_ms), 60000 - 12345);
+    CHECK_EQ(schedule_ms_until_deadline(&s, (int64_t)minute * 1000), 60000);  // on the boundary, the next one
+    CHECK_EQ(schedule_ms_until_deadline(&s, (int64_t)minute * 1000 - 1), 1);
+
+    // an alarm before the minute is up
+    char const * const titles[] = { "Dentist" };
+    time_t alarms[] = { minute + 30 };
+    _apply(&s, titles, alarms, 1, _now);
+    CHECK_EQ(schedule_ms_until_deadline(&s, now_ms), 30000 - 12345);
+
+    // one that is due, or passed, doesn't hold up the minute
+    CHECK_EQ(schedule_ms_until_deadline(&s, (int64_t)(minute + 30) * 1000), 30000);
+    CHECK_EQ(schedule_ms_until_deadline(&s, (int64_t)(minute + 45) * 1000), 15000);
+
+    // nor does one after it
+    alarms[0] = minute + 90;
+    _apply(&s, titles, alarms, 1, _now);
+    CHECK_EQ(schedule_ms_until_deadline(&s, now_ms), 60000 - 12345);
+    CHECK_EQ(schedule_ms_until_deadline(&s, (int64_t)(minute + 75) * 1000), 15000);
+}
+
+int
+main(void)
+{
+    TEST_RUN(test_order_and_alarms);
+    TEST_RUN(test_resend);
+    TEST_RUN(test_remove);
+    TEST_RUN(test_full);
+    TEST_RUN(test_random);
+    TEST_RUN(test_deadline);
+    TEST_EXIT();
+}
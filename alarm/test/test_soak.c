@@ -0,0 +1,400 @@
+/**
+ * @brief test_soak, a year of polls replayed through the message pool and the schedule
+ *
+ * © Copyright 2016, 2022, Sander and Coert Vonk
+ *
+ * This file is part of CALalarm.
+ *
+ * CALalarm is free software: you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * CALalarm is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with CALalarm.
+ * If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ **/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <malloc.h>
+
+#include "msg_pool.h"
+#include "calendar_json.h"
+#include "schedule.h"
+#include "poll_schedule.h"
+#include "tz.h"
+#include "test.h"
+
+// The https client and display task loops, without the network and FreeRTOS.  A calendar
+// that is edited a few times a day is served as the Apps Script does: the 48-hour
+// window, without the events when they match the hash that was sent.  Polls follow
+// poll_schedule, push notifications come in between, and every so often the display task
+// is too busy to keep up so its queue fills.  Over a year, the blocks in use, the
+// schedule and the heap must stay flat, and every alarm must go off once.
+
+#define ZONE "CET-1CEST,M3.5.0,M10.5.0/3"
+#define BASE_S (12 * 60)
+#define MAX_S (60 * 60)
+#define QUEUE_LEN (2)  // as created in main.c
+#define DAYS (365)
+#define REVS (DAYS + 2)
+#define EVENTS_PER_DAY (5)
+
+static time_t const _t0 = 1672531200;  // 2023-01-01 00:00 UTC
+
+static char const * const _titles[] = {
+    "Standup", "Dentist", "Gym", "Lunch with Ann", "1:1", "Pick up kids", "Piano lesson",
+    "Team retro", "Groceries", "Call mom", "Dinner", "Planning", "Review", "Yoga",
+};
+
+typedef enum { MSG_CALENDAR, MSG_STATUS } msg_type_t;
+
+typedef struct msg_t {
+    msg_type_t type;
+    void * data;
+} msg_t;
+
+typedef struct queue_t {
+    msg_t msgs[QUEUE_LEN];
+    uint len;
+} queue_t;
+
+// like xQueueSendToBack() with no wait: the sender returns the block when it is full
+static bool
+_send(queue_t * const q, msg_type_t const type, void * const data)
+{
+    if (q->len == QUEUE_LEN) {
+        msg_pool_free(data);
+        return false;
+    }
+    q->msgs[q->len++] = (msg_t) { .type = type, .data = data };
+    return true;
+}
+
+static bool
+_receive(queue_t * const q, msg_t * const msg)
+{
+    if (!q->len) {
+        return false;
+    }
+    *msg = q->msgs[0];
+    memmove(&q->msgs[0], &q->msgs[1], --q->len * sizeof(msg_t));
+    return true;
+}
+
+static uint32_t
+_hash32(uint32_t x)
+{
+    x ^= x >> 16;
+    x *= 0x7feb352d;
+    x ^= x >> 15;
+    x *= 0x846ca68b;
+    return x ^ (x >> 16);
+}
+
+static uint32_t
+_random32(uint32_t * const seed)
+{
+    *seed = *seed * 1103515245 + 12345;
+    return *seed >> 8;
+}
+
+typedef struct server_t {
+    tz_t tz;
+    int32_t day0;      // local day of `_t0`
+    uint revs[REVS];   // edits to each day
+    uint32_t seed;
+} server_t;
+
+typedef struct day_event_t {
+    uint start_min, stop_min;  // local time of day
+    char title[24];
+} day_event_t;
+
+// the events on local day `day0 + dd`, as they are after its latest edit
+static uint
+_day_events(server_t const * const server, uint const dd, day_event_t events[EVENTS_PER_DAY])
+{
+    uint32_t seed = _hash32(dd * 7919 + server->revs[dd] * 104729);
+    uint const len = seed % (EVENTS_PER_DAY + 1);
+    for (uint ii = 0; ii < len; ii++) {
+        seed = _hash32(seed + ii);
+        events[ii].start_min = 7 * 60 + (ii * 150) + (seed % 8) * 15;  // 07:00 .. 20:15, in order
+        events[ii].stop_min = events[ii].start_min + 30 + (seed >> 8) % 4 * 30;
+        if ((seed >> 16) % 6) {
+            strcpy(events[ii].title, _titles[(seed >> 20) % (sizeof(_titles) / sizeof(_titles[0]))]);
+        } else {
+            snprintf(events[ii].title, sizeof(events[ii].title), "Call #%u", (uint)((seed >> 4) % 100000));
+        }
+    }
+    return len;
+}
+
+static time_t
+_local2utc(server_t * const server, int32_t const day, uint const min)
+{
+    time_t const local = (time_t)day * 86400 + min * 60;
+    return local - tz_lookup(&server->tz, local - 3600, NULL, NULL, NULL);  // no events in the DST hours
+}
+
+static size_t
+_stamp(server_t * const server, char * const buf, time_t const t)
+{
+    struct tm tm;
+    tz_localtime(&server->tz, t, &tm);
+    return strftime(buf, 32, "\"%Y-%m-%d %H:%M:%S\"", &tm);
+}
+
+static uint
+_today(server_t * const server, time_t const now)
+{
+    struct tm tm;
+    tz_localtime(&server->tz, now, &tm);
+    return tz_days_from_civil(tm.tm_year + 1900, tm.tm_mon + 1, tm.tm_mday) - server->day0;
+}
+
+// the Apps Script
+static size_t
+_serve(server_t * const server, char * const json, time_t const now, char const * const hash)
+{
+    uint const today = _today(server, now);
+    uint32_t h = _hash32(today);
+    for (uint dd = today; dd < today + 2 && dd < REVS; dd++) {
+        h = _hash32(h ^ server->revs[dd]);
+    }
+    char window_hash[16];
+    snprintf(window_hash, sizeof(window_hash), "%08x", (unsigned)h);
+
+    size_t len = sprintf(json, "{\"time\":");
+    len += _stamp(server, json + len, now);
+    len += sprintf(json + len, ",\"pushId\":\"%s\",\"hash\":\"%s\",\"events\":[",
+                   now / 86400 % 7 ? "push-channel-1234567890" : "", window_hash);
+    if (strcmp(hash, window_hash) != 0) {
+        bool first = true;
+        for (uint dd = today; dd < today + 2 && dd < REVS; dd++) {
+            day_event_t events[EVENTS_PER_DAY];
+            uint const events_len = _day_events(server, dd, events);
+            for (uint ii = 0; ii < events_len; ii++) {
+                time_t const stop = _local2utc(server, server->day0 + dd, events[ii].stop_min);
+                if (stop <= now) {
+                    continue;
+                }
+                time_t const start = _local2utc(server, server->day0 + dd, events[ii].start_min);
+                len += sprintf(json + len, "%s{\"title\":\"%s\",\"alarm\":", first ? "" : ",", events[ii].title);
+                len += _stamp(server, json + len, start - 10 * 60);
+                len += sprintf(json + len, ",\"start\":");
+                len += _stamp(server, json + len, start);
+                len += sprintf(json + len, ",\"stop\":");
+                len += _stamp(server, json + len, stop);
+                len += sprintf(json + len, "}");
+                first = false;
+            }
+        }
+    }
+    len += sprintf(json + len, "]}");
+    return len;
+}
+
+typedef struct soak_t {
+    uint polls, payloads, dropped, statuses, pushes, alarms, edits;
+    size_t heap;        // in use after the first month
+    uint heap_changed;  // months in which it was different
+    msg_pool_stats_t pool;
+} soak_t;
+
+static void
+_check_pool_idle(void)
+{
+    msg_pool_stats_t stats;
+    msg_pool_get_stats(&stats);
+    CHECK_EQ(stats.small_used, 0);
+    CHECK_EQ(stats.large_used, 0);
+}
+
+static void
+test_year(void)
+{
+    static server_t server;
+    static schedule_t schedule;
+    static poll_schedule_t poll;
+    static char json[16 * 1024];
+    queue_t to_display = { .len = 0 }, to_client = { .len = 0 };
+    soak_t soak = { .polls = 0 };
+
+    memset(&server, 0, sizeof(server));
+    CHECK(tz_init(&server.tz, ZONE));
+    server.day0 = _t0 / 86400;
+    schedule_init(&schedule);
+    poll_schedule_init(&poll, BASE_S, MAX_S);
+    char hash[24] = "";  // of the events the display task has
+
+    time_t now = _t0;
+    time_t next_poll = _t0, next_edit = _t0 + 3600, next_push = _t0 + 5000;
+    time_t const end = _t0 + DAYS * 86400LL;
+    uint32_t seed = 1;
+    int month = -1;
+    uint busy = 0;  // polls that the display task doesn't get to its queue
+
+    while (now < end) {
+
+        // what the calendar owner does
+        if (now >= next_edit) {
+            uint const today = _today(&server, now);
+            uint const dd = today + 1 + _random32(&seed) % 2;  // tomorrow or the day after
+            if (dd < REVS) {
+                server.revs[dd]++;
+                soak.edits++;
+            }
+            next_edit = now + 3600 + _random32(&seed) % (8 * 3600);
+        }
+        if (now >= next_push) {
+            // httpd hands the notification to the https client
+            char * const block = msg_pool_strdup("{\"kind\":\"api#channel\",\"resourceState\":\"exists\"}");
+            CHECK(block != NULL);
+            if (to_client.len < QUEUE_LEN) {
+                to_client.msgs[to_client.len++] = (msg_t) { .type = MSG_STATUS, .data = block };
+            } else {
+                msg_pool_free(block);
+            }
+            soak.pushes++;
+            next_push = now + 3600 + _random32(&seed) % (24 * 3600);
+        }
+
+        // https_client_task
+        msg_t push;
+        if (now >= next_poll || _receive(&to_client, &push)) {
+            if (now < next_poll) {
+                msg_pool_free(push.data);
+            }
+            soak.polls++;
+            calendar_json_payload_t * payload = msg_pool_alloc(sizeof(calendar_json_payload_t));
+            CHECK(payload != NULL);
+            if (payload) {
+                calendar_json_payload_init(payload, &server.tz);
+                size_t const len = _serve(&server, json, now, hash);
+                for (size_t ii = 0; ii < len; ii += 512) {  // as the body arrives
+                    calendar_json_feed(&payload->json, json + ii, ii + 512 < len ? 512 : len - ii);
+                }
+                calendar_json_t const * const p = &payload->json;
+                CHECK_EQ(calendar_json_status(p), CALENDAR_JSON_DONE);
+                CHECK_EQ(p->events_dropped, 0);
+                bool const unchanged = p->hash && strcmp(p->hash, hash) == 0;
+                struct tm tm;
+                tz_localtime(&server.tz, now, &tm);
+                poll_schedule_polled(&poll, now, tm.tm_hour, !unchanged && hash[0]);
+                if (!unchanged) {
+                    poll_schedule_clear_alarms(&poll);
+                    for (uint ii = 0; ii < p->events_len; ii++) {
+                        poll_schedule_add_alarm(&poll, p->events[ii].alarm);
+                    }
+                    char new_hash[sizeof(hash)];
+                    strcpy(new_hash, p->hash);
+                    if (_send(&to_display, MSG_CALENDAR, payload)) {
+                        strcpy(hash, new_hash);
+                        soak.payloads++;
+                    } else {
+                        soak.dropped++;
+                    }
+                    payload = NULL;
+                }
+                msg_pool_free(payload);
+            }
+            char status[32];
+            snprintf(status, sizeof(status), "polled %u", soak.polls);
+            char * const block = msg_pool_strdup(status);
+            CHECK(block != NULL);
+            if (block && _send(&to_display, MSG_STATUS, block)) {
+                soak.statuses++;
+            }
+            struct tm tm;
+            tz_localtime(&server.tz, now, &tm);
+            next_poll = now + poll_schedule_interval(&poll, now, tm.tm_hour, false);
+            if (busy) {
+                busy--;
+            } else if (_random32(&seed) % 50 == 0) {
+                busy = 1 + _random32(&seed) % 4;
+            }
+        }
+
+        // display_task
+        msg_t msg;
+        while (!busy && _receive(&to_display, &msg)) {
+            if (msg.type == MSG_CALENDAR) {
+                calendar_json_t const * const p = &((calendar_json_payload_t *)msg.data)->json;
+                schedule_begin(&schedule);
+                for (uint ii = 0; ii < p->events_len; ii++) {
+                    calendar_json_event_t const * const e = &p->events[ii];
+                    CHECK(schedule_add(&schedule, e->title, e->alarm, e->start, e->stop, p->time));
+                }
+                schedule_end(&schedule, true);
+            }
+            msg_pool_free(msg.data);
+        }
+        schedule_event_t const * alarm;
+        while ((alarm = schedule_next_alarm(&schedule)) && alarm->alarm <= now) {
+            CHECK_EQ(alarm->alarm, now);  // no later than it should
+            soak.alarms++;
+            schedule_pop_alarm(&schedule);
+        }
+        if (!busy && !to_client.len) {
+            _check_pool_idle();
+        }
+        CHECK(schedule.titles_len <= SCHEDULE_TITLE_POOL);
+
+        // heap in use, once a month
+        struct tm tm;
+        tz_localtime(&server.tz, now, &tm);
+        if (tm.tm_mon != month) {
+            month = tm.tm_mon;
+            size_t const heap = mallinfo2().uordblks;
+            if (month == 1) {
+                soak.heap = heap;
+            } else if (month > 1 && heap != soak.heap) {
+                soak.heap_changed++;
+            }
+        }
+
+        // on to whatever comes first
+        time_t next = next_poll < next_edit ? next_poll : next_edit;
+        next = next_push < next ? next_push : next;
+        if ((alarm = schedule_next_alarm(&schedule)) && alarm->alarm < next) {
+            next = alarm->alarm;
+        }
+        now = to_client.len && next > now ? now : next;
+    }
+
+    // every alarm in the final calendar, after the first poll, went off once
+    uint expected = 0;
+    for (uint dd = 0; dd < DAYS; dd++) {
+        day_event_t events[EVENTS_PER_DAY];
+        expected += _day_events(&server, dd, events);
+    }
+    CHECK_EQ(soak.alarms, expected);
+
+    msg_pool_get_stats(&soak.pool);
+    CHECK_EQ(soak.pool.failed, 0);
+    CHECK_EQ(soak.pool.foreign, 0);
+    CHECK(soak.pool.large_max <= QUEUE_LEN + 1);  // in the queue, and the one being filled
+    CHECK_EQ(soak.heap_changed, 0);
+    printf("  %u days, %u polls, %u pushes, %u edits; %u payloads (%u dropped), %u alarms\n",
+           DAYS, soak.polls, soak.pushes, soak.edits, soak.payloads, soak.dropped, soak.alarms);
+    printf("  msg_pool max %u small, %u large blocks, heap in use %zu bytes every month\n",
+           soak.pool.small_max, soak.pool.large_max, soak.heap);
+}
+
+int
+main(void)
+{
+    setenv("TZ", ZONE, 1);  // close to DST edges, the parser falls back to mktime()
+    tzset();
+
+    TEST_RUN(test_year);
+    TEST_EXIT();
+}
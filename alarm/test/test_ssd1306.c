@@ -0,0 +1,442 @@
+/**
+ * @brief test_ssd1306, runs the ssd1306 component on a host, against the emulated panel
+ *
+ * © Copyright 2016, 2022, Sander and Coert Vonk
+ *
+ * This file is part of CALalarm.
+ *
+ * CALalarm is free software: you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * CALalarm is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with CALalarm.
+ * If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ **/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "ssd1306.h"
+#include "mock.h"
+#include "test.h"
+
+// Drives the I2C and SPI paths of the ssd1306 component the way the alarm does, and
+// checks that the emulated GDDRAM ends up as the driver thinks (`_sent`), that the
+// bus counters agree with what the emulator received, and that nothing the datasheet
+// forbids goes out.  The bus numbers it prints are the baseline for display changes.
+// The frame tests leave a PBM of the panel in the build directory.
+
+#define SPI_MOSI (13)
+#define SPI_SCLK (14)
+#define SPI_CS (15)
+#define SPI_DC (2)
+#define SPI_RESET (-1)
+#define STATUS_PAGE (3)  // also the marquee page
+
+typedef enum bus_t {
+    BUS_I2C,
+    BUS_SPI
+} bus_t;
+
+static char const * const _bus_names[] = { "i2c", "spi" };
+
+// initialized like display_task does
+static void
+_panel(SSD1306_t * const dev, bus_t const bus)
+{
+    mock_reset();
+    memset(dev, 0, sizeof(SSD1306_t));
+    if (bus == BUS_I2C) {
+        i2c_master_init(dev, CONFIG_SSD1306_SDA_GPIO, CONFIG_SSD1306_SCL_GPIO, CONFIG_SSD1306_RESET_GPIO);
+    } else {
+        mock_spi_set_dc(SPI_DC);
+        spi_master_init(dev, SPI_MOSI, SPI_SCLK, SPI_CS, SPI_DC, SPI_RESET);
+    }
+    ssd1306_init(dev, 128, 32);
+    ssd1306_clear_screen(dev, false);
+    ssd1306_contrast(dev, 0xff);
+}
+
+// the pages the driver knows the contents of, are what the panel holds
+static void
+_check_mirror(SSD1306_t const * const dev)
+{
+    for (int page = 0; page < dev->_pages; page++) {
+        if (dev->_page[page]._valid) {
+            CHECK(memcmp(mock_panel.ram[page], dev->_page[page]._sent, dev->_width) == 0);
+        }
+    }
+}
+
+// what the driver counted, went over the bus
+static void
+_check_stats(SSD1306_t * const dev)
+{
+    ssd1306_stats_t stats;
+    ssd1306_get_stats(dev, &stats, false);
+    CHECK_EQ(stats.bytes, mock_panel.stats.bytes);
+    CHECK_EQ(stats.transactions, mock_panel.stats.transactions);
+    CHECK_EQ(stats.wire_us, mock_panel.stats.wire_us);
+    CHECK_EQ(mock_panel.stats.unknown, 0);
+    CHECK_EQ(mock_panel.stats.violations, 0);
+    CHECK_EQ(mock_stats.errors, 0);
+}
+
+static void
+_print_stats(bus_t const bus, char const * const what, SSD1306_t * const dev)
+{
+    ssd1306_stats_t stats;
+    ssd1306_get_stats(dev, &stats, false);
+    printf("  %s %-14s %5u bytes %3u transactions %6u us on the wire %4u bytes skipped\n",
+           _bus_names[bus], what, stats.bytes, stats.transactions, stats.wire_us, stats.skipped);
+}
+
+// measure from here on, on both sides of the bus
+static void
+_reset_stats(SSD1306_t * const dev)
+{
+    ssd1306_stats_t stats;
+    ssd1306_get_stats(dev, &stats, true);
+    memset(&mock_panel.stats, 0, sizeof(mock_panel.stats));
+}
+
+static void
+_write_pbm(char const * const name)
+{
+    FILE * const f = fopen(name, "w");
+    CHECK(f != NULL);
+    if (f) {
+        ssd1306_emu_pbm(&mock_panel, f);
+        fclose(f);
+    }
+}
+
+// same as oled_flush_task does for each frame: the scroll is only stopped when the
+// marquee text changes, the other pages are written while it scrolls
+static void
+_flush(SSD1306_t * const dev, int const marquee_page, uint8_t strip[128], bool * const marquee_active)
+{
+    if (*marquee_active &&
+        (marquee_page < 0 || memcmp(strip, dev->_page[marquee_page]._segs, dev->_width) != 0)) {
+        ssd1306_hardware_scroll_pages(dev, SCROLL_STOP, STATUS_PAGE, STATUS_PAGE, 0);
+        *marquee_active = false;
+    }
+    ssd1306_show_dirty(dev);
+    if (marquee_page >= 0 && !*marquee_active) {
+        memcpy(strip, dev->_page[marquee_page]._segs, dev->_width);
+        ssd1306_hardware_scroll_pages(dev, SCROLL_LEFT, marquee_page, marquee_page, 0);
+        *marquee_active = true;
+    }
+}
+
+static void
+_compose(SSD1306_t * const dev, char const * const clock, char const * const status)
+{
+    ssd1306_compose_text_x3(dev, 0, 0, clock, strlen(clock), false);
+    ssd1306_compose_text_prop(dev, STATUS_PAGE, 0, status, dev->_width, false);
+}
+
+static void
+_test_init(bus_t const bus)
+{
+    SSD1306_t dev;
+    _panel(&dev, bus);
+
+    CHECK(mock_panel.on);
+    CHECK_EQ(ssd1306_emu_height(&mock_panel), 32);
+    CHECK_EQ(mock_panel.contrast, 0xFF);
+    CHECK_EQ(mock_panel.addr_mode, 0x02);
+    CHECK(mock_panel.seg_remap);
+    CHECK(mock_panel.com_remap);
+    CHECK(!mock_panel.scroll.active);
+    _check_stats(&dev);
+    _print_stats(bus, "init", &dev);
+}
+
+static void
+test_init_i2c(void)
+{
+    _test_init(BUS_I2C);
+}
+
+static void
+test_init_spi(void)
+{
+    _test_init(BUS_SPI);
+}
+
+// full frame, then one digit, then nothing
+static void
+_test_frames(bus_t const bus)
+{
+    SSD1306_t dev;
+    _panel(&dev, bus);
+
+    _reset_stats(&dev);
+    _compose(&dev, "12:34", "Dentist at 10:30");
+    ssd1306_show_dirty(&dev);
+    _check_mirror(&dev);
+    _check_stats(&dev);
+    CHECK_EQ(mock_panel.stats.data, dev._pages * dev._width);
+    _print_stats(bus, "full frame", &dev);
+
+    _reset_stats(&dev);
+    _compose(&dev, "12:35", "Dentist at 10:30");
+    ssd1306_show_dirty(&dev);
+    _check_mirror(&dev);
+    _check_stats(&dev);
+    CHECK(mock_panel.stats.data > 0);
+    CHECK(mock_panel.stats.data < (uint32_t)dev._width);
+    _print_stats(bus, "one digit", &dev);
+
+    _reset_stats(&dev);
+    ssd1306_show_dirty(&dev);
+    CHECK_EQ(mock_panel.stats.bytes, 0);
+    _check_stats(&dev);
+
+    char name[256];
+    snprintf(name, sizeof(name), TEST_OUTPUT_DIR "/ssd1306_%s.pbm", _bus_names[bus]);
+    _write_pbm(name);
+}
+
+static void
+test_frames_i2c(void)
+{
+    _test_frames(BUS_I2C);
+}
+
+static void
+test_frames_spi(void)
+{
+    _test_frames(BUS_SPI);
+}
+
+static void
+_test_contrast(bus_t const bus)
+{
+    SSD1306_t dev;
+    _panel(&dev, bus);
+
+    _reset_stats(&dev);
+    ssd1306_contrast(&dev, 0x40);
+    CHECK_EQ(mock_panel.contrast, 0x40);
+    ssd1306_contrast(&dev, 0x1FF);  // clamped
+    CHECK_EQ(mock_panel.contrast, 0xFF);
+    _check_stats(&dev);
+    _print_stats(bus, "2x contrast", &dev);
+}
+
+static void
+test_contrast_i2c(void)
+{
+    _test_contrast(BUS_I2C);
+}
+
+static void
+test_contrast_spi(void)
+{
+    _test_contrast(BUS_SPI);
+}
+
+// the controller scrolls the marquee page, while the clock is repainted around it
+static void
+_test_marquee(bus_t const bus)
+{
+    SSD1306_t dev;
+    _panel(&dev, bus);
+    bool marquee = false;
+    uint8_t strip[128];
+
+    _reset_stats(&dev);
+    _compose(&dev, "12:34", "Meet the team in the big room");
+    _flush(&dev, STATUS_PAGE, strip, &marquee);
+    _check_stats(&dev);
+    CHECK(mock_panel.scroll.active);
+    CHECK_EQ(mock_panel.scroll.setup, OLED_CMD_HORIZONTAL_LEFT);
+    CHECK_EQ(mock_panel.scroll.start, STATUS_PAGE);
+    CHECK_EQ(mock_panel.scroll.end, STATUS_PAGE);
+    _print_stats(bus, "marquee frame", &dev);
+
+    // the page moves left, and what falls off comes back on the right
+    uint const steps = 5;
+    ssd1306_emu_scroll(&mock_panel, steps);
+    for (int col = 0; col < dev._width; col++) {
+        CHECK_EQ(mock_panel.ram[STATUS_PAGE][col], dev._page[STATUS_PAGE]._segs[(col + steps) % dev._width]);
+    }
+    CHECK(memcmp(mock_panel.ram[0], dev._page[0]._segs, dev._width) == 0);
+
+    // a new clock digit leaves the scroll running, and its page where it was
+    _reset_stats(&dev);
+    _compose(&dev, "12:35", "Meet the team in the big room");
+    _flush(&dev, STATUS_PAGE, strip, &marquee);
+    _check_stats(&dev);
+    _check_mirror(&dev);
+    CHECK(mock_panel.scroll.active);
+    CHECK(mock_panel.stats.scroll_writes > 0);
+    CHECK_EQ(mock_panel.ram[STATUS_PAGE][0], dev._page[STATUS_PAGE]._segs[steps]);
+    _print_stats(bus, "marquee digit", &dev);
+
+    // a new text stops the scroll first, and rewrites the shifted page
+    _reset_stats(&dev);
+    _compose(&dev, "12:35", "Meet the team in room 4");
+    _flush(&dev, STATUS_PAGE, strip, &marquee);
+    _check_stats(&dev);
+    CHECK(memcmp(mock_panel.ram[STATUS_PAGE], dev._page[STATUS_PAGE]._segs, dev._width) == 0);
+    CHECK(mock_panel.scroll.active);
+
+    // writing the page while it scrolls is what the datasheet forbids, and the emulator notices
+    _compose(&dev, "12:36", "Lunch");
+    dev._hsEnable = false;
+    ssd1306_show_dirty(&dev);
+    dev._hsEnable = true;
+    CHECK(mock_panel.stats.violations > 0);
+
+    // and the marquee ends with a static status
+    mock_panel.stats.violations = 0;
+    _compose(&dev, "12:36", "Free");
+    _flush(&dev, -1, strip, &marquee);
+    CHECK(!mock_panel.scroll.active);
+    CHECK_EQ(mock_panel.stats.violations, 0);
+    _check_mirror(&dev);
+    CHECK(memcmp(mock_panel.ram[STATUS_PAGE], dev._page[STATUS_PAGE]._segs, dev._width) == 0);
+}
+
+static void
+test_marquee_i2c(void)
+{
+    _test_marquee(BUS_I2C);
+}
+
+static void
+test_marquee_spi(void)
+{
+    _test_marquee(BUS_SPI);
+}
+
+// a run that didn't make it to the panel, goes out again with the next frame
+static void
+_test_resend(bus_t const bus)
+{
+    SSD1306_t dev;
+    _panel(&dev, bus);
+    _compose(&dev, "12:34", "Dentist at 10:30");
+    ssd1306_show_dirty(&dev);
+
+    _compose(&dev, "12:35", "Dentist at 10:30");
+    mock_fail(1);
+    ssd1306_show_dirty(&dev);
+    CHECK(memcmp(mock_panel.ram[0], dev._page[0]._segs, dev._width) != 0);
+    _check_mirror(&dev);
+
+    ssd1306_show_dirty(&dev);
+    for (int page = 0; page < dev._pages; page++) {
+        CHECK(memcmp(mock_panel.ram[page], dev._page[page]._segs, dev._width) == 0);
+    }
+    _check_mirror(&dev);
+}
+
+static void
+test_resend_i2c(void)
+{
+    _test_resend(BUS_I2C);
+}
+
+static void
+test_resend_spi(void)
+{
+    _test_resend(BUS_SPI);
+}
+
+// the blocking calls are done with the caller's buffer when they return, also over SPI
+static void
+test_display_spi(void)
+{
+    SSD1306_t dev;
+    _panel(&dev, BUS_SPI);
+
+    uint8_t image[32];
+    for (uint ii = 0; ii < sizeof(image); ii++) {
+        image[ii] = ii * 7;
+    }
+    ssd1306_display_image(&dev, 1, 16, image, sizeof(image));
+    uint8_t expected_image[sizeof(image)];
+    memcpy(expected_image, image, sizeof(image));
+    memset(image, 0xA5, sizeof(image));  // what a caller's stack does next
+    CHECK(memcmp(&mock_panel.ram[1][16], expected_image, sizeof(expected_image)) == 0);
+
+    char text[] = "Dentist";
+    ssd1306_display_text(&dev, 2, text, strlen(text), false);
+    CHECK(memcmp(mock_panel.ram[2], dev._page[2]._segs, strlen(text) * 8) == 0);
+
+    char clock[] = "12:34";
+    ssd1306_display_text_x3(&dev, 0, clock, strlen(clock), false);
+    for (int page = 0; page < 3; page++) {
+        CHECK(memcmp(mock_panel.ram[page], dev._page[page]._segs, strlen(clock) * 24) == 0);
+    }
+    CHECK_EQ(mock_stats.errors, 0);
+    _check_mirror(&dev);
+}
+
+// ssd1306_dump_pbm() prints the driver's mirror, that should be what the panel shows
+static void
+test_dump_pbm(void)
+{
+    SSD1306_t dev;
+    _panel(&dev, BUS_I2C);
+    _compose(&dev, "9:41", "Lunch");
+    ssd1306_show_dirty(&dev);
+
+    char * panel;
+    size_t panel_len;
+    FILE * f = open_memstream(&panel, &panel_len);
+    ssd1306_emu_pbm(&mock_panel, f);
+    fclose(f);
+
+    char dump[8192];
+    f = tmpfile();
+    CHECK(f != NULL);
+    if (!f) {
+        free(panel);
+        return;
+    }
+    fflush(stdout);
+    int const saved = dup(STDOUT_FILENO);
+    dup2(fileno(f), STDOUT_FILENO);
+    ssd1306_dump_pbm(&dev);
+    fflush(stdout);
+    dup2(saved, STDOUT_FILENO);
+    close(saved);
+    rewind(f);
+    size_t const dump_len = fread(dump, 1, sizeof(dump), f);
+    fclose(f);
+
+    CHECK_EQ(dump_len, panel_len);
+    CHECK(memcmp(dump, panel, panel_len) == 0);
+    free(panel);
+}
+
+int
+main(void)
+{
+    TEST_RUN(test_init_i2c);
+    TEST_RUN(test_init_spi);
+    TEST_RUN(test_frames_i2c);
+    TEST_RUN(test_frames_spi);
+    TEST_RUN(test_contrast_i2c);
+    TEST_RUN(test_contrast_spi);
+    TEST_RUN(test_marquee_i2c);
+    TEST_RUN(test_marquee_spi);
+    TEST_RUN(test_resend_i2c);
+    TEST_RUN(test_resend_spi);
+    TEST_RUN(test_display_spi);
+    TEST_RUN(test_dump_pbm);
+    TEST_EXIT();
+}
@@ -0,0 +1,213 @@
+/**
+ * @brief test_ssd1306_anim, the frame clock of the animation engine
+ *
+ * © Copyright 2016, 2022, Sander and Coert Vonk
+ *
+ * This file is part of CALalarm.
+ *
+ * CALalarm is free software: you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * CALalarm is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with CALalarm.
+ * If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ **/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "freertos/task.h"
+#include "ssd1306.h"
+#include "mock.h"
+#include "test.h"
+
+// The engine takes the time from its caller, so these drive ssd1306_anim_step() with
+// made-up tick counts: on time, late, and early.
+
+static void
+_panel(SSD1306_t * const dev)
+{
+    mock_reset();
+    memset(dev, 0, sizeof(SSD1306_t));
+    i2c_master_init(dev, CONFIG_SSD1306_SDA_GPIO, CONFIG_SSD1306_SCL_GPIO, CONFIG_SSD1306_RESET_GPIO);
+    ssd1306_init(dev, 128, 32);
+    srand(1);
+    for (int page = 0; page < dev->_pages; page++) {
+        for (int seg = 0; seg < dev->_width; seg++) {
+            dev->_page[page]._segs[seg] = rand();
+        }
+    }
+    ssd1306_show_dirty(dev);
+}
+
+static bool
+_same(SSD1306_t const * const a, SSD1306_t const * const b)
+{
+    for (int page = 0; page < a->_pages; page++) {
+        if (memcmp(a->_page[page]._segs, b->_page[page]._segs, a->_width) != 0) return false;
+    }
+    return true;
+}
+
+// the blocking wrapper still takes `delay` ticks for each page it sends
+static void
+test_wrap_arround_delay(void)
+{
+    SSD1306_t dev;
+    _panel(&dev);
+    SSD1306_t const before = dev;
+
+    TickType_t const start = xTaskGetTickCount();
+    ssd1306_wrap_arround(&dev, SCROLL_LEFT, 0, dev._pages - 1, 3);
+    CHECK_EQ(xTaskGetTickCount() - start, 3 * dev._pages);
+    for (int page = 0; page < dev._pages; page++) {
+        for (int seg = 0; seg < dev._width; seg++) {
+            CHECK_EQ(dev._page[page]._segs[seg], before._page[page]._segs[(seg + 1) % dev._width]);
+        }
+        CHECK(memcmp(mock_panel.ram[page], dev._page[page]._segs, dev._width) == 0);
+    }
+
+    ssd1306_wrap_arround(&dev, SCROLL_RIGHT, 0, dev._pages - 1, 0);
+    CHECK_EQ(xTaskGetTickCount() - start, 3 * dev._pages);
+    CHECK(_same(&dev, &before));
+}
+
+// a caller that is on time gets every frame, one period apart
+static void
+test_on_time(void)
+{
+    SSD1306_t dev;
+    _panel(&dev);
+    ssd1306_anim_t anim;
+    uint const steps = 10;
+    TickType_t const period = 5;
+    ssd1306_anim_wrap(&anim, SCROLL_LEFT, 0, dev._pages - 1, steps, period);
+
+    TickType_t now = 100;
+    CHECK_EQ(ssd1306_anim_wait(&anim, now), 0);  // the first frame is due right away
+    uint frames = 0;
+    while (ssd1306_anim_active(&anim)) {
+        CHECK(ssd1306_anim_step(&dev, &anim, now));
+        ssd1306_show_dirty(&dev);
+        ssd1306_anim_flushed(&anim);
+        frames++;
+        if (!ssd1306_anim_active(&anim)) break;
+
+        CHECK_EQ(ssd1306_anim_wait(&anim, now + 2), period - 2);
+        CHECK(!ssd1306_anim_step(&dev, &anim, now + 2));  // early, nothing to do
+        now += ssd1306_anim_wait(&anim, now);
+    }
+    CHECK_EQ(frames, steps);
+    CHECK_EQ(now, 100 + (steps - 1) * period);
+    CHECK_EQ(ssd1306_anim_wait(&anim, now), portMAX_DELAY);
+
+    ssd1306_anim_stats_t stats;
+    ssd1306_anim_get_stats(&anim, &stats, true);
+    CHECK_EQ(stats.frames, steps);
+    CHECK_EQ(stats.dropped, 0);
+    CHECK(stats.frame_us_sum >= stats.frame_us_max);
+    ssd1306_anim_get_stats(&anim, &stats, false);
+    CHECK_EQ(stats.frames, 0);
+}
+
+// a late caller gets fewer frames, but the effect ends where it would have, and when
+static void
+test_late(void)
+{
+    SSD1306_t dev, ref;
+    _panel(&dev);
+    ref = dev;
+    uint const steps = 10;
+    TickType_t const period = 5;
+
+    ssd1306_anim_t anim;
+    ssd1306_anim_wrap(&anim, SCROLL_DOWN, 0, dev._width - 1, steps, period);
+    TickType_t now = 1000;
+    TickType_t last = now;
+    while (ssd1306_anim_active(&anim)) {
+        if (ssd1306_anim_step(&dev, &anim, now)) {
+            ssd1306_anim_flushed(&anim);
+            last = now;
+        }
+        now += 12;  // more than two periods
+    }
+    ssd1306_anim_stats_t stats;
+    ssd1306_anim_get_stats(&anim, &stats, false);
+    printf("  late by 12 ticks at 5 a frame: %u frames, %u dropped\n", stats.frames, stats.dropped);
+    CHECK_EQ(stats.frames + stats.dropped, steps);
+    CHECK(stats.dropped > 0);
+    CHECK(last - 1000 >= (steps - 1) * period && last - 1000 < (steps - 1) * period + 12);
+
+    for (uint ii = 0; ii < steps; ii++) {
+        ssd1306_wrap_arround(&ref, SCROLL_DOWN, 0, ref._width - 1, 0);
+    }
+    CHECK(_same(&dev, &ref));
+}
+
+// one pixel row per frame, until all pages are dark, and no empty frames after that
+static void
+test_fadeout(void)
+{
+    SSD1306_t dev;
+    _panel(&dev);
+    ssd1306_anim_t anim;
+    ssd1306_anim_fadeout(&anim, 1);
+    TickType_t now = 0;
+    while (ssd1306_anim_active(&anim)) {
+        if (ssd1306_anim_step(&dev, &anim, now)) {
+            ssd1306_show_dirty(&dev);
+            ssd1306_anim_flushed(&anim);
+        }
+        now++;
+    }
+    ssd1306_anim_stats_t stats;
+    ssd1306_anim_get_stats(&anim, &stats, false);
+    CHECK_EQ(stats.frames, dev._pages * 8);
+    CHECK_EQ(stats.dropped, 0);
+    for (int page = 0; page < dev._pages; page++) {
+        for (int seg = 0; seg < dev._width; seg++) {
+            CHECK_EQ(mock_panel.ram[page][seg], 0);
+        }
+    }
+}
+
+// a bitmap appears 8 rows per frame
+static void
+test_reveal(void)
+{
+    SSD1306_t dev;
+    _panel(&dev);
+    for (int page = 0; page < dev._pages; page++) {
+        memset(dev._page[page]._segs, 0, dev._width);
+    }
+    uint8_t bitmap[4 * 32];
+    memset(bitmap, 0xFF, sizeof(bitmap));
+    ssd1306_anim_t anim;
+    ssd1306_anim_reveal(&anim, 0, 0, bitmap, 4, 32, false, 10);
+
+    for (int frame = 0; frame < dev._pages; frame++) {
+        CHECK(ssd1306_anim_step(&dev, &anim, frame * 10));
+        for (int page = 0; page < dev._pages; page++) {
+            CHECK_EQ(dev._page[page]._segs[0], page <= frame ? 0xFF : 0x00);
+        }
+    }
+    CHECK(!ssd1306_anim_active(&anim));
+}
+
+int
+main(void)
+{
+    TEST_RUN(test_wrap_arround_delay);
+    TEST_RUN(test_on_time);
+    TEST_RUN(test_late);
+    TEST_RUN(test_fadeout);
+    TEST_RUN(test_reveal);
+    TEST_EXIT();
+}
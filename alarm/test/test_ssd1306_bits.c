@@ -0,0 +1,215 @@
+/**
+ * @brief test_ssd1306_bits, the word-at-a-time kernels against the byte loops they replaced
+ *
+ * © Copyright 2016, 2022, Sander and Coert Vonk
+ *
+ * This file is part of CALalarm.
+ *
+ * CALalarm is free software: you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * CALalarm is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with CALalarm.
+ * If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ **/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ssd1306.h"
+#include "mock.h"
+#include "test.h"
+
+// The scalar loops are the ones ssd1306.c had before its kernels went word-at-a-time.
+// _rotate_bytes() is reached through ssd1306_rotate_byte() and ssd1306_flip(), and
+// _transpose8x8() through ssd1306_bitmaps().
+
+static uint8_t
+_scalar_rotate_byte(uint8_t ch1)
+{
+    uint8_t ch2 = 0;
+    for (int j = 0; j < 8; j++) {
+        ch2 = (ch2 << 1) + (ch1 & 0x01);
+        ch1 = ch1 >> 1;
+    }
+    return ch2;
+}
+
+static void
+_scalar_invert(uint8_t * const buf, size_t const blen)
+{
+    for (size_t i = 0; i < blen; i++) {
+        buf[i] = ~buf[i];
+    }
+}
+
+static void
+_scalar_flip(uint8_t * const buf, size_t const blen)
+{
+    for (size_t i = 0; i < blen; i++) {
+        buf[i] = _scalar_rotate_byte(buf[i]);
+    }
+}
+
+static void
+_scalar_bitmaps(SSD1306_t * const dev, int const xpos, int const ypos, uint8_t const * const bitmap, int const width, int const height, bool const invert)
+{
+    int page = ypos / 8;
+    int dstBits = ypos % 8;
+    int offset = 0;
+    for (int _height = 0; _height < height; _height++) {
+        int seg = xpos;
+        for (int index = 0; index < width; index++) {
+            for (int srcBits = 7; srcBits >= 0; srcBits--) {
+                uint8_t wk1 = bitmap[index + offset];
+                if (invert) wk1 = ~wk1;
+                dev->_page[page]._segs[seg] = ssd1306_copy_bit(wk1, srcBits, dev->_page[page]._segs[seg], dstBits);
+                seg++;
+            }
+        }
+        offset += width;
+        if (++dstBits == 8) {
+            page++;
+            dstBits = 0;
+        }
+    }
+}
+
+static void
+_random(uint8_t * const buf, size_t const len)
+{
+    for (size_t ii = 0; ii < len; ii++) {
+        buf[ii] = rand();
+    }
+}
+
+static void
+_panel(SSD1306_t * const dev)
+{
+    mock_reset();
+    memset(dev, 0, sizeof(SSD1306_t));
+    i2c_master_init(dev, CONFIG_SSD1306_SDA_GPIO, CONFIG_SSD1306_SCL_GPIO, CONFIG_SSD1306_RESET_GPIO);
+    ssd1306_init(dev, 128, 32);
+}
+
+static void
+test_rotate_byte(void)
+{
+    for (int ch = 0; ch < 256; ch++) {
+        CHECK_EQ(ssd1306_rotate_byte(ch), _scalar_rotate_byte(ch));
+    }
+}
+
+// every length up to a page and a bit, at every alignment
+static void
+test_invert_flip(void)
+{
+    srand(1);
+    for (size_t align = 0; align < 4; align++) {
+        for (size_t len = 0; len <= 132; len++) {
+            uint8_t buf[136], expected[136];
+            _random(buf, sizeof(buf));
+            memcpy(expected, buf, sizeof(buf));
+            ssd1306_invert(buf + align, len);
+            _scalar_invert(expected + align, len);
+            CHECK(memcmp(buf, expected, sizeof(buf)) == 0);
+            ssd1306_flip(buf + align, len);
+            _scalar_flip(expected + align, len);
+            CHECK(memcmp(buf, expected, sizeof(buf)) == 0);
+        }
+    }
+}
+
+// random bitmaps at every position that fits on a 128x32 panel, over random content
+static void
+test_bitmaps(void)
+{
+    srand(2);
+    SSD1306_t dev, expected;
+    _panel(&dev);
+    uint8_t bitmap[16 * 32];
+    for (uint ii = 0; ii < 2000; ii++) {
+        int const width = 1 + rand() % 16;  // [bytes]
+        int const height = 1 + rand() % 32;
+        int const xpos = rand() % (128 - width * 8 + 1);
+        int const ypos = rand() % (32 - height + 1);
+        bool const invert = rand() & 1;
+        _random(bitmap, width * height);
+        for (int page = 0; page < dev._pages; page++) {
+            _random(dev._page[page]._segs, 128);
+        }
+        expected = dev;
+        ssd1306_bitmaps(&dev, xpos, ypos, bitmap, width, height, invert);
+        _scalar_bitmaps(&expected, xpos, ypos, bitmap, width, height, invert);
+        bool same = true;
+        for (int page = 0; page < dev._pages; page++) {
+            same &= memcmp(dev._page[page]._segs, expected._page[page]._segs, 128) == 0;
+        }
+        if (!same) {
+            fprintf(stderr, "%dx%d at (%d,%d), invert %d\n", width * 8, height, xpos, ypos, invert);
+            test_failures++;
+            return;
+        }
+    }
+}
+
+// the host is not the ESP32, so these only compare the two on the same machine
+static void
+test_bench(void)
+{
+    uint const rounds = 20000;
+    uint8_t buf[4 * 128];
+    _random(buf, sizeof(buf));
+
+    uint64_t start = test_ns();
+    for (uint ii = 0; ii < rounds; ii++) {
+        _scalar_invert(buf, sizeof(buf));
+        _scalar_flip(buf, sizeof(buf));
+        __asm__ volatile("" : : "r"(buf) : "memory");
+    }
+    uint64_t const scalar_ns = (test_ns() - start) / rounds;
+    start = test_ns();
+    for (uint ii = 0; ii < rounds; ii++) {
+        ssd1306_invert(buf, sizeof(buf));
+        ssd1306_flip(buf, sizeof(buf));
+        __asm__ volatile("" : : "r"(buf) : "memory");
+    }
+    uint64_t const swar_ns = (test_ns() - start) / rounds;
+    printf("  invert and flip 512 bytes: %5llu ns bytewise, %5llu ns wordwise\n",
+           (unsigned long long)scalar_ns, (unsigned long long)swar_ns);
+
+    SSD1306_t dev;
+    _panel(&dev);
+    uint8_t bitmap[16 * 32];
+    _random(bitmap, sizeof(bitmap));
+    uint const bitmap_rounds = 2000;
+    start = test_ns();
+    for (uint ii = 0; ii < bitmap_rounds; ii++) {
+        _scalar_bitmaps(&dev, 0, 0, bitmap, 16, 32, ii & 1);
+    }
+    uint64_t const scalar_bitmap_ns = (test_ns() - start) / bitmap_rounds;
+    start = test_ns();
+    for (uint ii = 0; ii < bitmap_rounds; ii++) {
+        ssd1306_bitmaps(&dev, 0, 0, bitmap, 16, 32, ii & 1);
+    }
+    uint64_t const bitmap_ns = (test_ns() - start) / bitmap_rounds;
+    printf("  128x32 bitmap: %6llu ns bit by bit, %6llu ns transposed, including the flush\n",
+           (unsigned long long)scalar_bitmap_ns, (unsigned long long)bitmap_ns);
+}
+
+int
+main(void)
+{
+    TEST_RUN(test_rotate_byte);
+    TEST_RUN(test_invert_flip);
+    TEST_RUN(test_bitmaps);
+    TEST_RUN(test_bench);
+    TEST_EXIT();
+}
@@ -0,0 +1,182 @@
+/**
+ * @brief test_tz, local time from a compiled POSIX TZ rule
+ *
+ * © Copyright 2016, 2022, Sander and Coert Vonk
+ *
+ * This file is part of CALalarm.
+ *
+ * CALalarm is free software: you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * CALalarm is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with CALalarm.
+ * If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ **/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "tz.h"
+#include "test.h"
+
+// glibc evaluates the same POSIX TZ strings, so it is the reference.
+
+static char const * const _zones[] = {
+    "UTC0",
+    "EST5",
+    "PST8PDT,M3.2.0,M11.1.0",        // the alarm's default
+    "CET-1CEST,M3.5.0,M10.5.0/3",
+    "GMT0BST,M3.5.0/1,M10.5.0",
+    "AEST-10AEDT,M10.1.0,M4.1.0/3",  // DST at new year
+    "NZST-12NZDT,M9.5.0,M4.1.0/3",
+    "<+0330>-3:30",
+    "<-03>3<-02>,M3.5.0/-2,M10.5.0/-1",  // negative rule times
+    "XST3XDT,J60/2,J300/2",
+    "YST3YDT,59,299",
+};
+
+static time_t const _from = 1609459200;  // 2021-01-01
+static time_t const _until = 2240524800; // 2041-01-01
+
+static void
+_reference(char const * const zone)
+{
+    setenv("TZ", zone, 1);
+    tzset();
+}
+
+static bool
+_same_tm(struct tm const * const a, struct tm const * const b)
+{
+    return a->tm_year == b->tm_year && a->tm_mon == b->tm_mon && a->tm_mday == b->tm_mday &&
+           a->tm_hour == b->tm_hour && a->tm_min == b->tm_min && a->tm_sec == b->tm_sec &&
+           a->tm_wday == b->tm_wday && a->tm_yday == b->tm_yday && a->tm_isdst == b->tm_isdst;
+}
+
+static void
+_check_at(tz_t * const tz, char const * const zone, time_t const t)
+{
+    struct tm tm, ref;
+    tz_localtime(tz, t, &tm);
+    localtime_r(&t, &ref);
+    if (!_same_tm(&tm, &ref)) {
+        char buf[2][32];
+        strftime(buf[0], sizeof(buf[0]), "%F %T", &tm);
+        strftime(buf[1], sizeof(buf[1]), "%F %T", &ref);
+        fprintf(stderr, "%s at %lld: %s isdst=%d, expected %s isdst=%d\n",
+                zone, (long long)t, buf[0], tm.tm_isdst, buf[1], ref.tm_isdst);
+        test_failures++;
+    }
+}
+
+static void
+test_days_from_civil(void)
+{
+    CHECK_EQ(tz_days_from_civil(1970, 1, 1), 0);
+    CHECK_EQ(tz_days_from_civil(1969, 12, 31), -1);
+    CHECK_EQ(tz_days_from_civil(2000, 3, 1), 11017);
+    for (int y = 1900; y <= 2100; y += 7) {
+        for (uint m = 1; m <= 12; m++) {
+            struct tm tm = { .tm_year = y - 1900, .tm_mon = m - 1, .tm_mday = 28 };
+            CHECK_EQ((int64_t)tz_days_from_civil(y, m, 28) * 86400, timegm(&tm));
+        }
+    }
+}
+
+static void
+test_parse(void)
+{
+    tz_t tz;
+    for (uint ii = 0; ii < sizeof(_zones) / sizeof(_zones[0]); ii++) {
+        CHECK(tz_init(&tz, _zones[ii]));
+    }
+    CHECK(tz_init(&tz, NULL));
+    CHECK(tz_init(&tz, ""));
+
+    char const * const bad[] = { "X", "PST", "PST8PDT,M3.2.0", "PST8PDT,M13.2.0,M11.1.0", "PST8PDT,M3.2.0,M11.1.0x", "<+03" };
+    for (uint ii = 0; ii < sizeof(bad) / sizeof(bad[0]); ii++) {
+        CHECK(!tz_init(&tz, bad[ii]));
+        CHECK_EQ(tz_lookup(&tz, _from, NULL, NULL, NULL), 0);  // UTC
+    }
+
+    // without a rule, the US one applies
+    tz_t with_rule;
+    tz_init(&tz, "EST5EDT");
+    tz_init(&with_rule, "EST5EDT,M3.2.0,M11.1.0");
+    for (time_t t = _from; t < _from + 2 * 366 * 86400; t += 3600) {
+        CHECK_EQ(tz_lookup(&tz, t, NULL, NULL, NULL), tz_lookup(&with_rule, t, NULL, NULL, NULL));
+    }
+}
+
+// every hour or so for twenty years, and a second around each DST edge
+static void
+test_localtime(void)
+{
+    for (uint ii = 0; ii < sizeof(_zones) / sizeof(_zones[0]); ii++) {
+        char const * const zone = _zones[ii];
+        _reference(zone);
+        tz_t tz;
+        tz_init(&tz, zone);
+        for (time_t t = _from; t < _until; t += 3607) {
+            _check_at(&tz, zone, t);
+        }
+        time_t until;
+        for (time_t t = _from; t < _until; t = until) {
+            tz_lookup(&tz, t, NULL, &until, NULL);
+            _check_at(&tz, zone, until - 1);
+            _check_at(&tz, zone, until);
+        }
+        // going backwards recompiles the table too
+        for (time_t t = _until; t > _from; t -= 86400 * 29 + 3) {
+            _check_at(&tz, zone, t);
+        }
+    }
+}
+
+// carried forward in steps of less than a day, across months, years and DST edges
+static void
+test_clock_advance(void)
+{
+    static time_t const steps[] = { 1, 59, 61, 3599, 3600, 86399, 60 };
+    for (uint ii = 0; ii < sizeof(_zones) / sizeof(_zones[0]); ii++) {
+        char const * const zone = _zones[ii];
+        tz_t tz;
+        tz_init(&tz, zone);
+        tz_clock_t clock = {};
+        uint step = 0;
+        for (time_t t = _from; t < _from + 3 * 366 * 86400; t += steps[step++ % 7]) {
+            struct tm const * const tm = tz_clock_advance(&tz, &clock, t);
+            struct tm ref;
+            tz_localtime(&tz, t, &ref);
+            if (!_same_tm(tm, &ref)) {
+                fprintf(stderr, "%s: clock at %lld differs\n", zone, (long long)t);
+                test_failures++;
+                break;
+            }
+        }
+        // and a clock that jumps back, or far ahead, starts over
+        struct tm ref;
+        tz_localtime(&tz, _from, &ref);
+        CHECK(_same_tm(tz_clock_advance(&tz, &clock, _from), &ref));
+        tz_localtime(&tz, _until, &ref);
+        CHECK(_same_tm(tz_clock_advance(&tz, &clock, _until), &ref));
+    }
+}
+
+int
+main(void)
+{
+    TEST_RUN(test_days_from_civil);
+    TEST_RUN(test_parse);
+    TEST_RUN(test_localtime);
+    TEST_RUN(test_clock_advance);
+    TEST_EXIT();
+}
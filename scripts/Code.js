@@ -5,7 +5,7 @@
 let timezone = Session.getScriptTimeZone();  // update in appsscript.json if needed
 
 function test() {
-    let e = { 'parameter': { 'devName': 'calalarm', 'pushId': null } };
+    let e = { 'parameter': { 'devName': 'calalarm', 'pushId': null, 'hash': null } };
     doGet(e);
 }
 
@@ -30,6 +30,13 @@ function bytesToString(bytes) {
     return str;
 }
 
+// identifies the events, so the device can tell us what it already has
+function eventsHash(events) {
+
+    const digest = Utilities.computeDigest(Utilities.DigestAlgorithm.SHA_1, JSON.stringify(events), Utilities.Charset.UTF_8);
+    return digest.slice(0, 8).map(byte => ((byte + 256) % 256).toString(16).padStart(2, '0')).join('');
+}
+
 // https://code.google.com/p/google-apps-script-issues/issues/detail?id=4433
 function _alarmTime(event) {
 
@@ -39,37 +46,23 @@ function _alarmTime(event) {
     let reminders = event.getPopupReminders();  
     // known issue: method getPopupReminders() doesn't return anything if there is only one reminder
     if (reminders.length == 0) {
-        reminder = 0;   
+        reminders = [0];  // alarm at the start of the event
     }
     const longestReminder = Math.max.apply(null, reminders)*60*1000;
     const date = new Date(event.getStartTime().getTime() - longestReminder);
     return date;
 }
 
-function _findFirstAlarm(events) {
-
-    let firstAlarmIdx = undefined;
-    let firstAlarmTime = undefined;
-    
-    for (let ii = 0; ii < events.length; ii++) {
-        const event = events[ii];    
-        switch(event.getMyStatus()) {
-            case CalendarApp.GuestStatus.OWNER:
-            case CalendarApp.GuestStatus.YES:
-            case CalendarApp.GuestStatus.MAYBE:
-                let alarmTime = _alarmTime(event);
-                if (firstAlarmTime == undefined || alarmTime < firstAlarmTime) {
-                    firstAlarmIdx = ii;
-                }
-                break;
-            default:
-                break;
-        }
-    }
-    if (firstAlarmIdx == undefined) {
-        return undefined;
+function _participating(event) {
+
+    switch(event.getMyStatus()) {
+        case CalendarApp.GuestStatus.OWNER:
+        case CalendarApp.GuestStatus.YES:
+        case CalendarApp.GuestStatus.MAYBE:
+            return !event.isAllDayEvent();
+        default:
+            return false;
     }
-    return events[firstAlarmIdx];
 }
 
 // https://stackoverflow.com/questions/10867405/generating-v5-uuid-what-is-name-and-namespace
@@ -146,38 +139,30 @@ function doGet(e) {
         return ContentService.createTextOutput('no access to calendar (' + email + ')');
     }
 
-    // find the first event today that I'm participating in, and that is not an all day event.
+    // all events in the next 48 hours that I'm participating in, and that are not all day events.
+    // the device keeps them, so a later change or a second alarm doesn't need another round trip.
 
     const now = new Date();
-    let todayStart = new Date(); todayStart.setHours(0, 0, 0);  // start at midnight this day
-    const oneday = 24*3600000; // [msec]
-    const todayStop = new Date(todayStart.getTime() + oneday - 1);
-    let eventsToday = cal.getEvents(todayStart, todayStop);
-    let firstAlarmToday = _findFirstAlarm(eventsToday);
-    
-    // find the first event tomorrow that I'm participating in, and that is not an all day event.
-
-    const tomorrowStart = new Date(todayStart.getTime() + oneday);
-    const tomorrowStop = new Date(tomorrowStart.getTime() + oneday - 1);
-    let eventsTomorrow = cal.getEvents(tomorrowStart, tomorrowStop);
-    let firstAlarmTomorrow = _findFirstAlarm(eventsTomorrow);
-    
-    // select the alarm event that should trigger the alarm
-
-    const event = firstAlarmToday != undefined && _alarmTime(firstAlarmToday) > now ? firstAlarmToday : firstAlarmTomorrow;
+    const window = 48 * 3600000; // [msec]
+    let events = cal.getEvents(now, new Date(now.getTime() + window)).filter(_participating);
+    events.sort((a, b) => _alarmTime(a) - _alarmTime(b));
+
+    const jsonEvents = events.map(event => ({
+        "alarm": localTime(_alarmTime(event)),
+        "start": localTime(event.getStartTime()),
+        "stop": localTime(event.getEndTime()),
+        "title": event.getTitle()
+    }));
+    const hash = eventsHash(jsonEvents);
 
     let json = {
         "time": localTime(now),
         "pushId": pushId,
-        "events": []
+        "hash": hash
     };
-    if (event) {
-        json.events.push({
-            "alarm": localTime(_alarmTime(event)),
-            "start": localTime(event.getStartTime()),
-            "stop": localTime(event.getEndTime()),
-            "title": event.getTitle()
-        });
+    // when the device already has these events, it only needs the time and pushId
+    if (e.parameter.hash !== hash) {
+        json.events = jsonEvents;
     }
 
     return ContentService.createTextOutput(JSON.stringify(json)).setMimeType(ContentService.MimeType.JSON);